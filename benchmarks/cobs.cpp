@@ -0,0 +1,195 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "cobs.hpp"
+#include "libreach/packet.hpp"
+#include "libreach/packet_id.hpp"
+#include "libreach/stream_decoder.hpp"
+#include "simd.hpp"
+
+namespace
+{
+
+using libreach::protocol::InstructionSet;
+
+/// Generate a byte stream that resembles a capture of joint telemetry from a Bravo 7.
+auto make_capture(std::size_t size) -> std::vector<std::uint8_t>
+{
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-3.14F, 3.14F);
+
+  const std::vector<libreach::PacketId> packet_ids = {
+    libreach::PacketId::POSITION, libreach::PacketId::VELOCITY, libreach::PacketId::CURRENT};
+
+  std::vector<std::uint8_t> capture;
+  capture.reserve(size + libreach::protocol::MAX_ENCODED_PACKET_SIZE);
+
+  while (capture.size() < size) {
+    for (std::uint8_t device_id = 1; device_id <= 7; ++device_id) {
+      for (const auto packet_id : packet_ids) {
+        const float value = dist(rng);
+        std::vector<std::uint8_t> data(sizeof(value));
+        std::memcpy(data.data(), &value, sizeof(value));
+
+        const auto frame = libreach::protocol::encode_packet(libreach::Packet(packet_id, device_id, data));
+        capture.insert(capture.end(), frame.begin(), frame.end());
+      }
+    }
+  }
+
+  return capture;
+}
+
+/// Generate a buffer of random bytes in which roughly one in every `zero_interval` bytes is zero.
+auto make_buffer(std::size_t size, std::uint32_t zero_interval) -> std::vector<std::uint8_t>
+{
+  std::mt19937 rng(0);
+  std::vector<std::uint8_t> buffer(size);
+
+  for (auto & byte : buffer) {
+    byte = (zero_interval > 0 && rng() % zero_interval == 0) ? 0x00 : static_cast<std::uint8_t>(rng() % 255 + 1);
+  }
+
+  return buffer;
+}
+
+auto use_instruction_set(benchmark::State & state) -> bool
+{
+  const auto isa = static_cast<InstructionSet>(state.range(0));
+
+  if (!libreach::protocol::set_instruction_set(isa)) {
+    state.SkipWithError("The instruction set is not supported by this CPU.");
+    return false;
+  }
+
+  return true;
+}
+
+auto find_zero(benchmark::State & state) -> void
+{
+  if (!use_instruction_set(state)) {
+    return;
+  }
+
+  const auto buffer = make_buffer(1 << 20, 0);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(libreach::protocol::find_zero(buffer));
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+}
+
+auto encode_cobs(benchmark::State & state) -> void
+{
+  if (!use_instruction_set(state)) {
+    return;
+  }
+
+  const auto buffer = make_buffer(1 << 16, 64);
+  std::vector<std::uint8_t> encoded(libreach::protocol::max_cobs_encoded_size(buffer.size()));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(libreach::protocol::encode_cobs(buffer, encoded));
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+}
+
+auto decode_cobs(benchmark::State & state) -> void
+{
+  if (!use_instruction_set(state)) {
+    return;
+  }
+
+  const auto buffer = make_buffer(1 << 16, 64);
+  std::vector<std::uint8_t> encoded = libreach::protocol::encode_cobs(buffer);
+  encoded.pop_back();
+
+  std::vector<std::uint8_t> decoded(encoded.size());
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(libreach::protocol::decode_cobs(encoded, decoded));
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * encoded.size()));
+}
+
+auto stream_decode(benchmark::State & state) -> void
+{
+  if (!use_instruction_set(state)) {
+    return;
+  }
+
+  const auto capture = make_capture(1 << 22);
+
+  std::size_t n_packets = 0;
+  libreach::protocol::StreamDecoder decoder([&n_packets](libreach::PacketView) { n_packets++; });
+
+  // Replay the capture in chunks that are similar to the reads performed by a client
+  const std::size_t chunk_size = 4096;
+
+  for (auto _ : state) {
+    for (std::size_t pos = 0; pos < capture.size(); pos += chunk_size) {
+      decoder.decode(std::span(capture).subspan(pos, std::min(chunk_size, capture.size() - pos)));
+    }
+  }
+
+  benchmark::DoNotOptimize(n_packets);
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * capture.size()));
+}
+
+auto register_benchmark(const char * name, void (*fn)(benchmark::State &)) -> void
+{
+  benchmark::RegisterBenchmark(name, fn)
+    ->ArgName("isa")
+    ->Arg(static_cast<int>(InstructionSet::SCALAR))
+    ->Arg(static_cast<int>(InstructionSet::SSE2))
+    ->Arg(static_cast<int>(InstructionSet::AVX2));
+}
+
+}  // namespace
+
+auto main(int argc, char ** argv) -> int
+{
+  // Benchmarks are parameterized by the instruction set; refer to libreach::protocol::InstructionSet for the values
+  register_benchmark("find_zero", find_zero);
+  register_benchmark("encode_cobs", encode_cobs);
+  register_benchmark("decode_cobs", decode_cobs);
+  register_benchmark("stream_decode", stream_decode);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
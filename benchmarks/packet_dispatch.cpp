@@ -0,0 +1,123 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libreach/capture.hpp"
+#include "libreach/packet.hpp"
+#include "libreach/packet_id.hpp"
+#include "libreach/replay_driver.hpp"
+
+namespace
+{
+
+/// A driver that exposes the dispatch of received packets to the worker threads. An empty capture is replayed so that
+/// packets are only received from the benchmark.
+class DispatchDriver : public libreach::ReplayDriver
+{
+public:
+  DispatchDriver(const std::string & path, std::size_t n_workers, libreach::DispatchMode dispatch_mode)
+  : libreach::ReplayDriver(
+      path,
+      libreach::protocol::ReplaySpeed::MAXIMUM,
+      1024,
+      n_workers,
+      std::chrono::seconds(3),
+      dispatch_mode)
+  {
+  }
+
+  using libreach::ReachDriver::receive_packets;
+};
+
+/// Busy-wait for the given duration to simulate a callback that performs some computation.
+auto spin_for(std::chrono::nanoseconds duration) -> void
+{
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+/// Measure the rate at which batches of received packets are dispatched to the callbacks as the number of worker
+/// threads increases. The second argument is the time (ns) that each callback spends processing a packet, and the third
+/// argument is the dispatch mode (0 for any worker, 1 for per device).
+auto dispatch_throughput(benchmark::State & state) -> void
+{
+  const auto n_workers = static_cast<std::size_t>(state.range(0));
+  const std::chrono::nanoseconds work(state.range(1));
+  const auto dispatch_mode = static_cast<libreach::DispatchMode>(state.range(2));
+
+  const std::string path = "/tmp/libreach_dispatch_benchmark_" + std::to_string(getpid()) + ".cap";
+  {
+    libreach::protocol::CaptureWriter capture(path);
+  }
+
+  std::atomic<std::uint64_t> n_processed{0};
+
+  {
+    DispatchDriver driver(path, n_workers, dispatch_mode);
+    driver.register_callback<libreach::PacketId::POSITION>([&n_processed, work](std::uint8_t /*device_id*/, float) {
+      spin_for(work);
+      n_processed.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    // Simulate a burst of position updates from each joint of a Bravo 7
+    const std::vector<std::uint8_t> data = {0x00, 0x00, 0x80, 0x3F};
+    std::vector<libreach::Packet> batch;
+    for (std::size_t i = 0; i < 63; ++i) {
+      batch.emplace_back(libreach::PacketId::POSITION, static_cast<std::uint8_t>(i % 7 + 1), data);
+    }
+
+    std::uint64_t n_expected = 0;
+
+    for (auto _ : state) {
+      driver.receive_packets(batch);
+      n_expected += batch.size();
+
+      while (n_processed.load(std::memory_order_relaxed) < n_expected) {
+        std::this_thread::yield();
+      }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(n_expected));
+  }
+
+  unlink(path.c_str());
+}
+
+}  // namespace
+
+BENCHMARK(dispatch_throughput)
+  ->ArgNames({"workers", "work_ns", "per_device"})
+  ->ArgsProduct({{1, 2, 4, 8}, {0, 2000}, {0, 1}})
+  ->UseRealTime();
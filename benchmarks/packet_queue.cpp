@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <benchmark/benchmark.h>
+
+#include <boost/circular_buffer.hpp>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "libreach/packet.hpp"
+#include "libreach/packet_id.hpp"
+#include "mpmc_queue.hpp"
+
+namespace
+{
+
+/// A packet that stores its data in a heap-allocated vector; this mirrors the original packet layout.
+class VectorPacket
+{
+public:
+  explicit VectorPacket(libreach::PacketView view)
+  : packet_id_(view.packet_id()),
+    device_id_(view.device_id()),
+    data_(view.data().begin(), view.data().end())
+  {
+  }
+
+  [[nodiscard]] auto packet_id() const -> libreach::PacketId { return packet_id_; }
+
+private:
+  libreach::PacketId packet_id_;
+  std::uint8_t device_id_;
+  std::vector<std::uint8_t> data_;
+};
+
+/// Push a batch of packets through a locked circular buffer and pop them back off, replicating the work originally
+/// performed by ReachDriver::receive_packets and ReachDriver::process_packet.
+template <typename PacketT>
+auto push_pop(benchmark::State & state) -> void
+{
+  const auto batch_size = static_cast<std::size_t>(state.range(0));
+
+  // Simulate a position update from each joint of a Bravo 7
+  const std::vector<std::uint8_t> data = {0x00, 0x00, 0x80, 0x3F};
+  std::vector<libreach::PacketView> batch;
+  for (std::size_t i = 0; i < batch_size; ++i) {
+    batch.emplace_back(libreach::PacketId::POSITION, static_cast<std::uint8_t>(i % 7 + 1), data);
+  }
+
+  boost::circular_buffer<PacketT> packets(100);
+  std::mutex packets_lock;
+
+  for (auto _ : state) {
+    {
+      const std::lock_guard<std::mutex> lock(packets_lock);
+      for (const auto & view : batch) {
+        packets.push_back(PacketT(view));
+      }
+    }
+
+    while (true) {
+      std::unique_lock<std::mutex> lock(packets_lock);
+      if (packets.empty()) {
+        break;
+      }
+      const PacketT packet = std::move(packets.front());
+      packets.pop_front();
+      lock.unlock();
+
+      benchmark::DoNotOptimize(packet.packet_id());
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+}
+
+/// Push a batch of packets through the lock-free queue used by ReachDriver and pop them back off.
+auto push_pop_mpmc(benchmark::State & state) -> void
+{
+  const auto batch_size = static_cast<std::size_t>(state.range(0));
+
+  const std::vector<std::uint8_t> data = {0x00, 0x00, 0x80, 0x3F};
+  std::vector<libreach::PacketView> batch;
+  for (std::size_t i = 0; i < batch_size; ++i) {
+    batch.emplace_back(libreach::PacketId::POSITION, static_cast<std::uint8_t>(i % 7 + 1), data);
+  }
+
+  libreach::MpmcQueue<libreach::Packet> packets(100);
+
+  for (auto _ : state) {
+    for (const auto & view : batch) {
+      packets.try_push(libreach::Packet(view));
+    }
+
+    while (const auto packet = packets.try_pop()) {
+      benchmark::DoNotOptimize(packet->packet_id());
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch_size));
+}
+
+}  // namespace
+
+BENCHMARK(push_pop<VectorPacket>)->Name("push_pop/vector")->Arg(1)->Arg(7)->Arg(35);
+BENCHMARK(push_pop<libreach::Packet>)->Name("push_pop/inline")->Arg(1)->Arg(7)->Arg(35);
+BENCHMARK(push_pop_mpmc)->Name("push_pop/mpmc")->Arg(1)->Arg(7)->Arg(35);
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "libreach/capture.hpp"
+#include "libreach/packet.hpp"
+#include "libreach/packet_id.hpp"
+#include "libreach/packet_schema.hpp"
+#include "libreach/replay_client.hpp"
+
+namespace
+{
+
+/// Record a capture of position updates from each joint of a Bravo 7, read in 32-byte chunks as a serial client would.
+auto record_synthetic_capture(const std::string & path) -> void
+{
+  libreach::protocol::CaptureWriter capture(path);
+  std::vector<std::uint8_t> stream;
+
+  for (std::size_t i = 0; i < 100000; ++i) {
+    const auto packet = libreach::make_packet<libreach::PacketId::POSITION>(
+      static_cast<std::uint8_t>(i % 7 + 1),
+      static_cast<float>(i));
+    const std::vector<std::uint8_t> frame = libreach::protocol::encode_packet(packet);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+
+  for (std::size_t offset = 0; offset < stream.size(); offset += 32) {
+    capture.record(
+      libreach::protocol::CaptureDirection::RECEIVED,
+      std::span(stream).subspan(offset, std::min<std::size_t>(32, stream.size() - offset)));
+  }
+}
+
+/// Measure the rate at which captured traffic can be decoded and dispatched by replaying it at maximum speed. The
+/// capture named by the LIBREACH_CAPTURE environment variable is used if it is set; otherwise, a synthetic capture is
+/// recorded.
+auto replay_throughput(benchmark::State & state) -> void
+{
+  std::string path;
+  bool synthetic = false;
+
+  if (const char * capture = std::getenv("LIBREACH_CAPTURE"); capture != nullptr) {
+    path = capture;
+  } else {
+    path = "/tmp/libreach_replay_benchmark_" + std::to_string(getpid()) + ".cap";
+    record_synthetic_capture(path);
+    synthetic = true;
+  }
+
+  // Only the received bytes are replayed
+  std::uint64_t capture_size = 0;
+  libreach::protocol::CaptureReader reader(path);
+  while (auto record = reader.next()) {
+    if (record->direction == libreach::protocol::CaptureDirection::RECEIVED) {
+      capture_size += record->data.size();
+    }
+  }
+
+  std::uint64_t n_packets = 0;
+
+  for (auto _ : state) {
+    std::atomic<std::uint64_t> n_received{0};
+
+    libreach::protocol::ReplayClient client(
+      path,
+      [&n_received](libreach::PacketView /*packet*/) { n_received.fetch_add(1, std::memory_order_relaxed); },
+      std::chrono::seconds(3),
+      libreach::protocol::ReplaySpeed::MAXIMUM);
+
+    client.start();
+    client.wait_until_finished();
+
+    n_packets += n_received.load();
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(n_packets));
+  state.SetBytesProcessed(static_cast<std::int64_t>(capture_size * state.iterations()));
+
+  if (synthetic) {
+    unlink(path.c_str());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(replay_throughput)->UseRealTime()->Unit(benchmark::kMillisecond);
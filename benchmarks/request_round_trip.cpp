@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "emulator.hpp"
+#include "libreach/device_id.hpp"
+#include "libreach/packet_id.hpp"
+#include "libreach/serial_driver.hpp"
+#include "libreach/tcp_driver.hpp"
+#include "libreach/udp_driver.hpp"
+
+namespace
+{
+
+/// Repeatedly request the position of every joint and wait until all of the responses have been received.
+template <typename Driver>
+auto measure_round_trip(benchmark::State & state, Driver & driver, std::uint64_t n_joints) -> void
+{
+  std::atomic<std::uint64_t> n_received{0};
+  driver.template register_callback<libreach::PacketId::POSITION>(
+    [&n_received](std::uint8_t /*device_id*/, float /*position*/) {
+      n_received.fetch_add(1, std::memory_order_release);
+    });
+
+  std::uint64_t n_expected = 0;
+
+  for (auto _ : state) {
+    driver.request(libreach::PacketId::POSITION, static_cast<std::uint8_t>(libreach::Alpha5DeviceId::ALL_JOINTS));
+    n_expected += n_joints;
+
+    // Spin rather than block so that the measurement does not include the time needed to wake this thread
+    while (n_received.load(std::memory_order_acquire) < n_expected) {
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(n_expected));
+}
+
+/// Measure the time between requesting the position of every joint and receiving all of the responses, using an
+/// emulated Alpha 5 that is connected over a pseudo-terminal (transport 0), a loopback UDP socket (transport 1), or a
+/// loopback TCP connection (transport 2).
+auto request_round_trip(benchmark::State & state) -> void
+{
+  if (state.range(0) == 0) {
+    const auto emulator = libreach::emulator::Emulator::open_pty(libreach::emulator::Arm::ALPHA_5);
+    libreach::SerialDriver driver(emulator->port_name());
+    measure_round_trip(state, driver, emulator->device_ids().size());
+  } else if (state.range(0) == 1) {
+    const auto emulator = libreach::emulator::Emulator::open_udp(libreach::emulator::Arm::ALPHA_5);
+    libreach::UdpDriver driver("127.0.0.1", emulator->udp_port());
+    measure_round_trip(state, driver, emulator->device_ids().size());
+  } else {
+    const auto emulator = libreach::emulator::Emulator::open_tcp(libreach::emulator::Arm::ALPHA_5);
+    libreach::TcpDriver driver("127.0.0.1", emulator->tcp_port());
+    measure_round_trip(state, driver, emulator->device_ids().size());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(request_round_trip)->ArgName("transport")->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
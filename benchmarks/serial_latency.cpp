@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <benchmark/benchmark.h>
+#include <pty.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "libreach/packet.hpp"
+#include "libreach/packet_id.hpp"
+#include "libreach/serial_client.hpp"
+
+namespace
+{
+
+/// Measure the time between a device writing a packet and the packet callback being executed. A pseudo-terminal stands
+/// in for the device, so this measures the latency added by the client rather than by a USB serial adapter.
+auto serial_latency(benchmark::State & state) -> void
+{
+  int device = -1;
+  int port = -1;
+  std::array<char, PATH_MAX> port_name{};
+
+  if (openpty(&device, &port, port_name.data(), nullptr, nullptr) < 0) {
+    state.SkipWithError("Failed to open a pseudo-terminal.");
+    return;
+  }
+
+  {
+    std::atomic<std::uint64_t> n_received{0};
+
+    const libreach::protocol::SerialClient client(
+      port_name.data(),
+      [&n_received](libreach::PacketView /*packet*/) { n_received.fetch_add(1, std::memory_order_release); },
+      std::chrono::seconds(3),
+      32,
+      nullptr,
+      state.range(0) != 0);
+
+    // The model number doubles as the heartbeat, so the client remains connected for the duration of the benchmark
+    const libreach::Packet heartbeat(libreach::PacketId::MODEL_NUMBER, 0x01, {0x00, 0x00, 0x00, 0x00});
+    const std::vector<std::uint8_t> frame = libreach::protocol::encode_packet(heartbeat);
+
+    std::uint64_t n_sent = 0;
+
+    for (auto _ : state) {
+      if (write(device, frame.data(), frame.size()) != static_cast<ssize_t>(frame.size())) {
+        state.SkipWithError("Failed to write to the pseudo-terminal.");
+        break;
+      }
+      ++n_sent;
+
+      // Spin rather than block so that the measurement does not include the time needed to wake this thread
+      while (n_received.load(std::memory_order_acquire) < n_sent) {
+      }
+    }
+  }
+
+  close(port);
+  close(device);
+}
+
+}  // namespace
+
+BENCHMARK(serial_latency)->ArgName("low_latency")->Arg(0)->Arg(1)->UseRealTime();
@@ -0,0 +1,512 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "emulator.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pty.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+
+#include "libreach/client.hpp"
+#include "libreach/device_id.hpp"
+#include "libreach/packet_schema.hpp"
+
+namespace libreach::emulator
+{
+
+namespace
+{
+
+/// The longest time that the emulator waits for data before checking whether it should stop.
+const std::chrono::milliseconds POLL_PERIOD(20);
+
+/// The longest time that the emulator waits for a pseudo-terminal or TCP connection to become writable before dropping
+/// the data. Data is only dropped if no client is reading from the connection.
+const int WRITE_TIMEOUT_MS = 100;
+
+/// The number of bits used to transmit each byte on a serial link (8N1).
+const std::uint32_t BITS_PER_BYTE = 10;
+
+auto arm_device_ids(Arm arm) -> std::vector<std::uint8_t>
+{
+  if (arm == Arm::ALPHA_5) {
+    return {
+      static_cast<std::uint8_t>(Alpha5DeviceId::JOINT_A),
+      static_cast<std::uint8_t>(Alpha5DeviceId::JOINT_B),
+      static_cast<std::uint8_t>(Alpha5DeviceId::JOINT_C),
+      static_cast<std::uint8_t>(Alpha5DeviceId::JOINT_D),
+      static_cast<std::uint8_t>(Alpha5DeviceId::JOINT_E),
+    };
+  }
+
+  return {
+    static_cast<std::uint8_t>(Bravo7DeviceId::JOINT_A),
+    static_cast<std::uint8_t>(Bravo7DeviceId::JOINT_B),
+    static_cast<std::uint8_t>(Bravo7DeviceId::JOINT_C),
+    static_cast<std::uint8_t>(Bravo7DeviceId::JOINT_D),
+    static_cast<std::uint8_t>(Bravo7DeviceId::JOINT_E),
+    static_cast<std::uint8_t>(Bravo7DeviceId::JOINT_F),
+    static_cast<std::uint8_t>(Bravo7DeviceId::JOINT_G),
+  };
+}
+
+}  // namespace
+
+auto Emulator::open_pty(Arm arm, std::uint32_t baud_rate) -> std::unique_ptr<Emulator>
+{
+  int handle = -1;
+  int port_handle = -1;
+  std::array<char, PATH_MAX> port_name{};
+
+  if (openpty(&handle, &port_handle, port_name.data(), nullptr, nullptr) < 0) {
+    throw std::runtime_error("Failed to open a pseudo-terminal for the emulator");
+  }
+
+  // The client configures the port when it connects; until then, the port must not echo the emulator's writes
+  struct termios tty;
+  if (tcgetattr(port_handle, &tty) == 0) {
+    cfmakeraw(&tty);
+    tcsetattr(port_handle, TCSANOW, &tty);
+  }
+
+  fcntl(handle, F_SETFL, fcntl(handle, F_GETFL) | O_NONBLOCK);
+
+  return std::unique_ptr<Emulator>(new Emulator(arm, handle, port_handle, -1, port_name.data(), 0, 0, baud_rate));
+}
+
+auto Emulator::open_udp(Arm arm, std::uint16_t port) -> std::unique_ptr<Emulator>
+{
+  const int handle = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (handle < 0) {
+    throw std::runtime_error("Failed to open UDP socket for the emulator");
+  }
+
+  struct sockaddr_in sockaddr{};
+  sockaddr.sin_family = AF_INET;
+  sockaddr.sin_port = htons(port);
+  sockaddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  socklen_t sockaddr_size = sizeof(sockaddr);
+
+  if (
+    bind(handle, reinterpret_cast<struct sockaddr *>(&sockaddr), sizeof(sockaddr)) < 0 ||
+    getsockname(handle, reinterpret_cast<struct sockaddr *>(&sockaddr), &sockaddr_size) < 0) {
+    close(handle);
+    throw std::runtime_error("Failed to bind UDP socket for the emulator to port " + std::to_string(port));
+  }
+
+  return std::unique_ptr<Emulator>(new Emulator(arm, handle, -1, -1, "", ntohs(sockaddr.sin_port), 0, 0));
+}
+
+auto Emulator::open_tcp(Arm arm, std::uint16_t port) -> std::unique_ptr<Emulator>
+{
+  const int listen_handle = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (listen_handle < 0) {
+    throw std::runtime_error("Failed to open TCP socket for the emulator");
+  }
+
+  const int reuse = 1;
+  setsockopt(listen_handle, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  struct sockaddr_in sockaddr{};
+  sockaddr.sin_family = AF_INET;
+  sockaddr.sin_port = htons(port);
+  sockaddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  socklen_t sockaddr_size = sizeof(sockaddr);
+
+  if (
+    bind(listen_handle, reinterpret_cast<struct sockaddr *>(&sockaddr), sizeof(sockaddr)) < 0 ||
+    listen(listen_handle, 1) < 0 ||
+    getsockname(listen_handle, reinterpret_cast<struct sockaddr *>(&sockaddr), &sockaddr_size) < 0) {
+    close(listen_handle);
+    throw std::runtime_error("Failed to listen on TCP port " + std::to_string(port) + " for the emulator");
+  }
+
+  return std::unique_ptr<Emulator>(new Emulator(arm, -1, -1, listen_handle, "", 0, ntohs(sockaddr.sin_port), 0));
+}
+
+Emulator::Emulator(
+  Arm arm,
+  int handle,
+  int port_handle,
+  int listen_handle,
+  std::string port_name,
+  std::uint16_t udp_port,
+  std::uint16_t tcp_port,
+  std::uint32_t baud_rate)
+: arm_(arm),
+  device_ids_(arm_device_ids(arm)),
+  handle_(handle),
+  port_handle_(port_handle),
+  port_name_(std::move(port_name)),
+  udp_port_(udp_port),
+  listen_handle_(listen_handle),
+  tcp_port_(tcp_port),
+  baud_rate_(baud_rate),
+  read_buffer_(protocol::MAX_WRITE_SIZE),
+  decoder_([this](PacketView packet) { handle_packet(packet); })
+{
+  joints_.reserve(device_ids_.size());
+  for (const std::uint8_t device_id : device_ids_) {
+    joints_.push_back(Joint{device_id});
+  }
+
+  last_update_ = std::chrono::steady_clock::now();
+
+  running_.store(true);
+  thread_ = std::thread([this] { run(); });
+}
+
+Emulator::~Emulator()
+{
+  running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  if (handle_ >= 0) {
+    close(handle_);
+  }
+  if (port_handle_ >= 0) {
+    close(port_handle_);
+  }
+  if (listen_handle_ >= 0) {
+    close(listen_handle_);
+  }
+}
+
+auto Emulator::port_name() const -> const std::string & { return port_name_; }
+
+auto Emulator::udp_port() const -> std::uint16_t { return udp_port_; }
+
+auto Emulator::tcp_port() const -> std::uint16_t { return tcp_port_; }
+
+auto Emulator::device_ids() const -> std::span<const std::uint8_t> { return device_ids_; }
+
+auto Emulator::packets_received() const -> std::uint64_t { return packets_received_.load(); }
+
+auto Emulator::packets_sent() const -> std::uint64_t { return packets_sent_.load(); }
+
+auto Emulator::run() -> void
+{
+  while (running_.load()) {
+    auto now = std::chrono::steady_clock::now();
+    update_joints(now);
+
+    // Wake up in time to send the next heartbeat
+    auto timeout = POLL_PERIOD;
+    if (heartbeat_frequency_ > 0) {
+      const auto until_heartbeat = std::chrono::ceil<std::chrono::milliseconds>(next_heartbeat_ - now);
+      timeout = std::clamp(until_heartbeat, std::chrono::milliseconds(0), timeout);
+    }
+
+    // Negative handles (e.g., the listening socket of other emulators) are ignored by poll
+    std::array<struct pollfd, 2> fds = {{{handle_, POLLIN, 0}, {listen_handle_, POLLIN, 0}}};
+    if (poll(fds.data(), fds.size(), static_cast<int>(timeout.count())) > 0) {
+      if ((fds[0].revents & POLLIN) != 0) {
+        read_available();
+      }
+      if ((fds[1].revents & POLLIN) != 0) {
+        accept_connection();
+      }
+    }
+
+    now = std::chrono::steady_clock::now();
+    if (heartbeat_frequency_ > 0 && now >= next_heartbeat_) {
+      for (const Joint & joint : joints_) {
+        for (const PacketId packet_id : heartbeat_packets_) {
+          respond(packet_id, joint);
+        }
+      }
+
+      // Skip the heartbeats that were missed rather than sending them in a burst
+      const auto period = std::chrono::nanoseconds(std::chrono::seconds(1)) / heartbeat_frequency_;
+      next_heartbeat_ = std::max(next_heartbeat_ + period, now);
+    }
+
+    flush();
+  }
+}
+
+auto Emulator::read_available() -> void
+{
+  // Drain the connection so that all of the packets that have arrived are answered together
+  while (true) {
+    ssize_t bytes_read = -1;
+
+    if (udp_port_ != 0) {
+      socklen_t peer_size = sizeof(peer_);
+      bytes_read = recvfrom(
+        handle_,
+        read_buffer_.data(),
+        read_buffer_.size(),
+        0,
+        reinterpret_cast<struct sockaddr *>(&peer_),
+        &peer_size);
+      has_peer_ = has_peer_ || bytes_read >= 0;
+    } else {
+      bytes_read = read(handle_, read_buffer_.data(), read_buffer_.size());
+    }
+
+    // A stream socket is readable with no data once the client has closed the connection
+    if (tcp_port_ != 0 && (bytes_read == 0 || (bytes_read < 0 && errno != EAGAIN && errno != EINTR))) {
+      close_connection();
+      return;
+    }
+
+    if (bytes_read <= 0) {
+      return;
+    }
+
+    decoder_.decode(std::span(read_buffer_).first(static_cast<std::size_t>(bytes_read)));
+
+    // A datagram is self-contained, so an incomplete frame is not continued by the next datagram
+    if (udp_port_ != 0) {
+      decoder_.reset();
+    }
+  }
+}
+
+auto Emulator::accept_connection() -> void
+{
+  const int handle = accept4(listen_handle_, nullptr, nullptr, SOCK_NONBLOCK);
+  if (handle < 0) {
+    return;
+  }
+
+  close_connection();
+  handle_ = handle;
+
+  // Responses are written in batches, so they are sent immediately rather than waiting to be coalesced
+  const int no_delay = 1;
+  setsockopt(handle_, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+}
+
+auto Emulator::close_connection() -> void
+{
+  if (handle_ >= 0) {
+    close(handle_);
+    handle_ = -1;
+  }
+
+  // A frame that was cut off by the connection closing is not continued by the next connection
+  decoder_.reset();
+}
+
+auto Emulator::handle_packet(PacketView packet) -> void
+{
+  packets_received_.fetch_add(1);
+
+  // Packets for the ALL_JOINTS device ID are handled by every joint
+  std::span<Joint> targets;
+  if (packet.device_id() == static_cast<std::uint8_t>(Alpha5DeviceId::ALL_JOINTS)) {
+    targets = joints_;
+  } else {
+    auto it = std::ranges::find(joints_, packet.device_id(), &Joint::device_id);
+    if (it == joints_.end()) {
+      return;
+    }
+    targets = std::span(it, 1);
+  }
+
+  for (Joint & joint : targets) {
+    switch (packet.packet_id()) {
+      case PacketId::REQUEST:
+        for (const std::uint8_t packet_id : packet.data()) {
+          respond(static_cast<PacketId>(packet_id), joint);
+        }
+        break;
+      case PacketId::HEARTBEAT_SET:
+        heartbeat_packets_.clear();
+        for (const std::uint8_t packet_id : packet.data()) {
+          heartbeat_packets_.push_back(static_cast<PacketId>(packet_id));
+        }
+        break;
+      case PacketId::HEARTBEAT_FREQUENCY:
+        if (auto fields = PacketSchema<PacketId::HEARTBEAT_FREQUENCY>::decode(packet.data())) {
+          heartbeat_frequency_ = std::get<0>(*fields);
+          next_heartbeat_ = std::chrono::steady_clock::now();
+        }
+        break;
+      case PacketId::MODE:
+        if (auto fields = PacketSchema<PacketId::MODE>::decode(packet.data())) {
+          joint.mode = std::get<0>(*fields);
+        }
+        break;
+      case PacketId::POSITION:
+        if (auto fields = PacketSchema<PacketId::POSITION>::decode(packet.data())) {
+          joint.mode = Mode::POSITION;
+          joint.position = std::get<0>(*fields);
+          joint.velocity = 0.0F;
+        }
+        break;
+      case PacketId::RELATIVE_POSITION:
+        if (auto fields = PacketSchema<PacketId::RELATIVE_POSITION>::decode(packet.data())) {
+          joint.mode = Mode::POSITION;
+          joint.position += std::get<0>(*fields);
+          joint.velocity = 0.0F;
+        }
+        break;
+      case PacketId::VELOCITY:
+        if (auto fields = PacketSchema<PacketId::VELOCITY>::decode(packet.data())) {
+          joint.mode = Mode::VELOCITY;
+          joint.velocity = std::get<0>(*fields);
+        }
+        break;
+      case PacketId::CURRENT:
+        if (auto fields = PacketSchema<PacketId::CURRENT>::decode(packet.data())) {
+          joint.mode = Mode::CURRENT;
+          joint.current = std::get<0>(*fields);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+auto Emulator::respond(PacketId packet_id, const Joint & joint) -> void
+{
+  switch (packet_id) {
+    case PacketId::MODE:
+      responses_.push_back(make_packet<PacketId::MODE>(joint.device_id, joint.mode));
+      break;
+    case PacketId::POSITION:
+      responses_.push_back(make_packet<PacketId::POSITION>(joint.device_id, joint.position));
+      break;
+    case PacketId::VELOCITY:
+      responses_.push_back(make_packet<PacketId::VELOCITY>(joint.device_id, joint.velocity));
+      break;
+    case PacketId::CURRENT:
+      responses_.push_back(make_packet<PacketId::CURRENT>(joint.device_id, joint.current));
+      break;
+    case PacketId::SERIAL_NUMBER:
+      responses_.push_back(make_packet<PacketId::SERIAL_NUMBER>(joint.device_id, 1000.0F + joint.device_id));
+      break;
+    case PacketId::MODEL_NUMBER:
+      responses_.push_back(make_packet<PacketId::MODEL_NUMBER>(joint.device_id, arm_ == Arm::ALPHA_5 ? 5.0F : 7.0F));
+      break;
+    case PacketId::TEMPERATURE:
+      responses_.push_back(make_packet<PacketId::TEMPERATURE>(joint.device_id, 30.0F));
+      break;
+    case PacketId::VOLTAGE:
+      responses_.push_back(make_packet<PacketId::VOLTAGE>(joint.device_id, 24.0F));
+      break;
+    default:
+      break;
+  }
+}
+
+auto Emulator::update_joints(std::chrono::steady_clock::time_point now) -> void
+{
+  const std::chrono::duration<float> elapsed = now - last_update_;
+  last_update_ = now;
+
+  for (Joint & joint : joints_) {
+    if (joint.mode == Mode::VELOCITY) {
+      joint.position += joint.velocity * elapsed.count();
+    }
+  }
+}
+
+auto Emulator::flush() -> void
+{
+  if (responses_.empty()) {
+    return;
+  }
+
+  // There is nobody to respond to until a client has sent a datagram or connected
+  if ((udp_port_ != 0 && !has_peer_) || handle_ < 0) {
+    responses_.clear();
+    return;
+  }
+
+  std::array<std::uint8_t, protocol::MAX_WRITE_SIZE> buffer;
+  std::size_t buffer_size = 0;
+
+  for (const Packet & packet : responses_) {
+    // Packets are written individually when emulating a baud rate so that each arrives once it has been transmitted
+    if (buffer_size > 0 && (baud_rate_ > 0 || buffer.size() - buffer_size < protocol::MAX_ENCODED_PACKET_SIZE)) {
+      write_bytes(std::span(buffer).first(buffer_size));
+      buffer_size = 0;
+    }
+    buffer_size += protocol::encode_packet_into(packet, std::span(buffer).subspan(buffer_size));
+  }
+
+  write_bytes(std::span(buffer).first(buffer_size));
+
+  packets_sent_.fetch_add(responses_.size());
+  responses_.clear();
+}
+
+auto Emulator::write_bytes(std::span<const std::uint8_t> bytes) -> void
+{
+  if (udp_port_ != 0) {
+    sendto(handle_, bytes.data(), bytes.size(), 0, reinterpret_cast<struct sockaddr *>(&peer_), sizeof(peer_));
+    return;
+  }
+
+  if (baud_rate_ > 0) {
+    const auto transmit_time = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(bytes.size() * BITS_PER_BYTE) / baud_rate_));
+    link_free_at_ = std::max(link_free_at_, std::chrono::steady_clock::now()) + transmit_time;
+    std::this_thread::sleep_until(link_free_at_);
+  }
+
+  while (!bytes.empty()) {
+    // A client that closed its connection must not raise SIGPIPE in the process that hosts the emulator
+    const ssize_t bytes_written = tcp_port_ != 0 ? send(handle_, bytes.data(), bytes.size(), MSG_NOSIGNAL)
+                                                 : write(handle_, bytes.data(), bytes.size());
+
+    if (bytes_written >= 0) {
+      bytes = bytes.subspan(static_cast<std::size_t>(bytes_written));
+      continue;
+    }
+
+    if (errno == EINTR) {
+      continue;
+    }
+
+    // Wait for the client to read the data that has already been written
+    struct pollfd fd = {handle_, POLLOUT, 0};
+    if (errno != EAGAIN || poll(&fd, 1, WRITE_TIMEOUT_MS) <= 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace libreach::emulator
@@ -0,0 +1,183 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libreach/mode.hpp"
+#include "libreach/packet.hpp"
+#include "libreach/stream_decoder.hpp"
+
+namespace libreach::emulator
+{
+
+/// The arms that can be emulated; these determine the device IDs that respond to packets.
+enum class Arm : std::uint8_t
+{
+  ALPHA_5,
+  BRAVO_7,
+};
+
+/// Emulates a Reach arm so that drivers can be exercised without hardware. The emulator runs in its own thread and:
+///   - answers REQUEST packets with synthetic data for each joint,
+///   - sends the packets configured by HEARTBEAT_SET at the rate configured by HEARTBEAT_FREQUENCY,
+///   - tracks the mode and setpoints sent to each joint.
+class Emulator
+{
+public:
+  /// Create an emulator that communicates over a pseudo-terminal; clients connect to the port named by port_name().
+  /// If a baud rate is given, writes are paced to the rate at which a serial link with that baud rate transmits them.
+  static auto open_pty(Arm arm, std::uint32_t baud_rate = 0) -> std::unique_ptr<Emulator>;
+
+  /// Create an emulator that communicates over a UDP socket bound to the loopback address. If no port is given, a free
+  /// port is chosen; the port that was bound is available from udp_port().
+  static auto open_udp(Arm arm, std::uint16_t port = 0) -> std::unique_ptr<Emulator>;
+
+  /// Create an emulator that accepts TCP connections on the loopback address. Only the most recent connection is
+  /// served, so a client that reconnects replaces its previous connection. If no port is given, a free port is chosen;
+  /// the port that was bound is available from tcp_port().
+  static auto open_tcp(Arm arm, std::uint16_t port = 0) -> std::unique_ptr<Emulator>;
+
+  Emulator(const Emulator &) = delete;
+  auto operator=(const Emulator &) -> Emulator & = delete;
+
+  ~Emulator();
+
+  /// Get the name of the pseudo-terminal used by clients (e.g., "/dev/pts/3"); this is empty for socket emulators.
+  [[nodiscard]] auto port_name() const -> const std::string &;
+
+  /// Get the UDP port that the emulator is bound to; this is 0 for other emulators.
+  [[nodiscard]] auto udp_port() const -> std::uint16_t;
+
+  /// Get the TCP port that the emulator listens on; this is 0 for other emulators.
+  [[nodiscard]] auto tcp_port() const -> std::uint16_t;
+
+  /// Get the IDs of the devices that make up the emulated arm.
+  [[nodiscard]] auto device_ids() const -> std::span<const std::uint8_t>;
+
+  /// Get the number of packets that the emulator has received.
+  [[nodiscard]] auto packets_received() const -> std::uint64_t;
+
+  /// Get the number of packets that the emulator has sent.
+  [[nodiscard]] auto packets_sent() const -> std::uint64_t;
+
+private:
+  struct Joint
+  {
+    std::uint8_t device_id;
+    Mode mode{Mode::STANDBY};
+    float position{0.0F};
+    float velocity{0.0F};
+    float current{0.0F};
+  };
+
+  Emulator(
+    Arm arm,
+    int handle,
+    int port_handle,
+    int listen_handle,
+    std::string port_name,
+    std::uint16_t udp_port,
+    std::uint16_t tcp_port,
+    std::uint32_t baud_rate);
+
+  /// Read and respond to packets until the emulator is destroyed.
+  auto run() -> void;
+
+  /// Read the available bytes from the connection and decode them.
+  auto read_available() -> void;
+
+  /// Accept a pending TCP connection, replacing the current connection.
+  auto accept_connection() -> void;
+
+  /// Close the current TCP connection, e.g., once the client has closed it.
+  auto close_connection() -> void;
+
+  /// Respond to a packet received from a client.
+  auto handle_packet(PacketView packet) -> void;
+
+  /// Queue a packet with synthetic data for the given joint, if the emulator supports the packet.
+  auto respond(PacketId packet_id, const Joint & joint) -> void;
+
+  /// Advance the joints that are in velocity mode.
+  auto update_joints(std::chrono::steady_clock::time_point now) -> void;
+
+  /// Write the queued packets to the connection.
+  auto flush() -> void;
+
+  /// Write bytes to the connection, waiting for the connection to become writable if necessary.
+  auto write_bytes(std::span<const std::uint8_t> bytes) -> void;
+
+  Arm arm_;
+  std::vector<std::uint8_t> device_ids_;
+  std::vector<Joint> joints_;
+
+  // The pseudo-terminal emulator keeps the client's end open so that the connection is never hung up.
+  int handle_;
+  int port_handle_;
+  std::string port_name_;
+  std::uint16_t udp_port_{0};
+
+  // The TCP emulator serves the most recent connection accepted on its listening socket; the connection's handle is -1
+  // until a client connects.
+  int listen_handle_;
+  std::uint16_t tcp_port_{0};
+
+  // Datagrams are sent to the address of the most recent client.
+  struct sockaddr_in peer_{};
+  bool has_peer_{false};
+
+  // Writes are paced by the time that the emulated serial link needs to transmit each byte.
+  std::uint32_t baud_rate_;
+  std::chrono::steady_clock::time_point link_free_at_;
+
+  std::vector<PacketId> heartbeat_packets_;
+  std::uint8_t heartbeat_frequency_{0};
+  std::chrono::steady_clock::time_point next_heartbeat_;
+  std::chrono::steady_clock::time_point last_update_;
+
+  std::vector<std::uint8_t> read_buffer_;
+  protocol::StreamDecoder decoder_;
+  std::vector<Packet> responses_;
+
+  std::atomic<std::uint64_t> packets_received_{0};
+  std::atomic<std::uint64_t> packets_sent_{0};
+
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+};
+
+}  // namespace libreach::emulator
@@ -0,0 +1,127 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <signal.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "emulator.hpp"
+
+namespace
+{
+
+auto print_usage() -> void
+{
+  std::cout << "Usage: reach_emulator [--arm alpha5|bravo7] [--udp PORT | --tcp PORT] [--baud RATE]\n"
+            << "  --arm   the arm to emulate (default: alpha5)\n"
+            << "  --udp   listen on a loopback UDP port instead of a pseudo-terminal (0 chooses a free port)\n"
+            << "  --tcp   accept connections on a loopback TCP port instead of a pseudo-terminal (0 chooses a free port)\n"
+            << "  --baud  pace pseudo-terminal writes to the given baud rate\n";
+}
+
+}  // namespace
+
+/// Emulate a Reach arm until interrupted, e.g., `reach_emulator --arm bravo7 --baud 115200`.
+auto main(int argc, char ** argv) -> int
+{
+  libreach::emulator::Arm arm = libreach::emulator::Arm::ALPHA_5;
+  bool use_udp = false;
+  std::uint16_t udp_port = 0;
+  bool use_tcp = false;
+  std::uint16_t tcp_port = 0;
+  std::uint32_t baud_rate = 0;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+
+      if (arg == "--help" || arg == "-h") {
+        print_usage();
+        return 0;
+      }
+
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("Missing value for " + arg);
+      }
+
+      const std::string value = argv[++i];
+
+      if (arg == "--arm" && (value == "alpha5" || value == "bravo7")) {
+        arm = value == "alpha5" ? libreach::emulator::Arm::ALPHA_5 : libreach::emulator::Arm::BRAVO_7;
+      } else if (arg == "--udp") {
+        use_udp = true;
+        udp_port = static_cast<std::uint16_t>(std::stoul(value));
+      } else if (arg == "--tcp") {
+        use_tcp = true;
+        tcp_port = static_cast<std::uint16_t>(std::stoul(value));
+      } else if (arg == "--baud") {
+        baud_rate = static_cast<std::uint32_t>(std::stoul(value));
+      } else {
+        throw std::invalid_argument("Invalid argument " + arg + " " + value);
+      }
+    }
+  }
+  catch (const std::exception & e) {
+    std::cout << e.what() << "\n";
+    print_usage();
+    return 1;
+  }
+
+  // Block the termination signals so that they can be waited on while the emulator runs
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  std::unique_ptr<libreach::emulator::Emulator> emulator;
+  if (use_udp) {
+    emulator = libreach::emulator::Emulator::open_udp(arm, udp_port);
+  } else if (use_tcp) {
+    emulator = libreach::emulator::Emulator::open_tcp(arm, tcp_port);
+  } else {
+    emulator = libreach::emulator::Emulator::open_pty(arm, baud_rate);
+  }
+
+  if (use_udp) {
+    std::cout << "Emulating on UDP 127.0.0.1:" << emulator->udp_port() << "\n";
+  } else if (use_tcp) {
+    std::cout << "Emulating on TCP 127.0.0.1:" << emulator->tcp_port() << "\n";
+  } else {
+    std::cout << "Emulating on " << emulator->port_name() << "\n";
+  }
+
+  int signal = 0;
+  sigwait(&signals, &signal);
+
+  std::cout << "Received " << emulator->packets_received() << " packets and sent " << emulator->packets_sent()
+            << " packets\n";
+
+  return 0;
+}
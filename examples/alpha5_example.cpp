@@ -40,9 +40,9 @@ auto main() -> int
   // Create a new serial driver for the Alpha 5; connection will be attempted on construction
   libreach::SerialDriver driver(serial_port);
 
-  // Register a callback for the POSITION packet
-  driver.register_callback(libreach::PacketId::POSITION, [](const libreach::Packet & packet) {
-    std::cout << "Received POSITION packet with value: " << libreach::deserialize<float>(packet) << "\n";
+  // Register a callback for the POSITION packet; the packet data is deserialized according to the packet's schema
+  driver.register_callback<libreach::PacketId::POSITION>([](std::uint8_t /*device_id*/, float position) {
+    std::cout << "Received POSITION packet with value: " << position << "\n";
   });
 
   // Request POSITION data at 10 Hz from joint A
@@ -41,9 +41,9 @@ auto main() -> int
   // Create a new UDP driver for the Bravo 7; connection will be attempted on construction
   libreach::UdpDriver driver(ip_address, port);
 
-  // Register a callback for the POSITION packet
-  driver.register_callback(libreach::PacketId::POSITION, [](const libreach::Packet & packet) {
-    std::cout << "Received POSITION packet with value: " << libreach::deserialize<float>(packet) << "\n";
+  // Register a callback for the POSITION packet; the packet data is deserialized according to the packet's schema
+  driver.register_callback<libreach::PacketId::POSITION>([](std::uint8_t /*device_id*/, float position) {
+    std::cout << "Received POSITION packet with value: " << position << "\n";
   });
 
   // Request POSITION data at 10 Hz from joint A
@@ -46,7 +46,17 @@ auto main() -> int
   // Modify this value as needed based on the expected number of incoming packets.
   const std::size_t q_size = 100;
 
-  libreach::SerialDriver driver(serial_port, q_size, n_workers);
+  // Process the packets from each joint on the same worker thread so that the updates for a joint are handled in the
+  // order that they were received, while the joints are processed in parallel
+  libreach::SerialDriver driver(
+    serial_port,
+    q_size,
+    n_workers,
+    std::chrono::seconds(3),
+    false,
+    libreach::protocol::DEFAULT_BAUD_RATE,
+    libreach::TransmitMode::SYNCHRONOUS,
+    libreach::DispatchMode::PER_DEVICE);
 
   // Create a vector to store the joint positions
   std::vector<float> joint_positions(5, 0.0F);
@@ -56,12 +66,11 @@ auto main() -> int
   std::mutex m;
 
   // Register a callback for the POSITION packet
-  driver.register_callback(libreach::PacketId::POSITION, [&m, &joint_positions](const libreach::Packet & packet) {
-    const auto position = libreach::deserialize<float>(packet);
-
-    const std::lock_guard<std::mutex> lock(m);
-    joint_positions[static_cast<std::size_t>(packet.device_id()) - 1] = position;
-  });
+  driver.register_callback<libreach::PacketId::POSITION>(
+    [&m, &joint_positions](std::uint8_t device_id, float position) {
+      const std::lock_guard<std::mutex> lock(m);
+      joint_positions[static_cast<std::size_t>(device_id) - 1] = position;
+    });
 
   // Request position data at 100 Hz for each joint
   for (std::size_t i = 1; i <= 5; ++i) {
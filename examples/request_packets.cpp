@@ -37,19 +37,19 @@ auto main() -> int
   const std::string serial_port = "/dev/ttyUSB0";
   libreach::SerialDriver driver(serial_port);
 
-  driver.register_callback(libreach::PacketId::POSITION, [](const libreach::Packet & packet) {
+  driver.register_callback(libreach::PacketId::POSITION, [](libreach::PacketView packet) {
     std::cout << "Received POSITION packet with value: " << libreach::deserialize<float>(packet) << "\n";
   });
 
-  driver.register_callback(libreach::PacketId::VELOCITY, [](const libreach::Packet & packet) {
+  driver.register_callback(libreach::PacketId::VELOCITY, [](libreach::PacketView packet) {
     std::cout << "Received VELOCITY packet with value: " << libreach::deserialize<float>(packet) << "\n";
   });
 
-  driver.register_callback(libreach::PacketId::CURRENT, [](const libreach::Packet & packet) {
+  driver.register_callback(libreach::PacketId::CURRENT, [](libreach::PacketView packet) {
     std::cout << "Received CURRENT packet with value: " << libreach::deserialize<float>(packet) << "\n";
   });
 
-  driver.register_callback(libreach::PacketId::RELATIVE_POSITION, [](const libreach::Packet & packet) {
+  driver.register_callback(libreach::PacketId::RELATIVE_POSITION, [](libreach::PacketView packet) {
     std::cout << "Received RELATIVE_POSITION packet with value: " << libreach::deserialize<float>(packet) << "\n";
   });
 
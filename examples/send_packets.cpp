@@ -23,8 +23,10 @@
 // ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <array>
 #include <iostream>
 #include <string>
+#include <utility>
 
 #include "libreach/device_id.hpp"
 #include "libreach/packet.hpp"
@@ -32,7 +34,8 @@
 #include "libreach/serial_driver.hpp"
 
 // This example demonstrates the different approaches to sending packets to a robot using libreach.
-// WARNING: This will set the joint position of joint A. Verify that the joint is clear of obstacles before running.
+// WARNING: This will set the joint positions of joints D and E. Verify that the joints are clear of obstacles before
+// running.
 auto main() -> int
 {
   const std::string serial_port = "/dev/ttyUSB0";
@@ -57,6 +60,14 @@ auto main() -> int
   auto packet = libreach::Packet(libreach::PacketId::POSITION, joint_a, bytes);
   driver.send_packet(packet);
 
+  // 4. Packets with a known schema can be sent without manually serializing their data
+  driver.send_packet<libreach::PacketId::POSITION>(joint_a, desired_position);
+
+  // 5. Commands for multiple joints can be sent together in a single write
+  const auto joint_d = static_cast<std::uint8_t>(libreach::Alpha5DeviceId::JOINT_D);
+  const std::array<std::pair<std::uint8_t, float>, 2> positions = {{{joint_a, desired_position}, {joint_d, 1.57F}}};
+  driver.set_position(positions);
+
   // Let the driver run indefinitely
   while (true) {
     std::this_thread::sleep_for(std::chrono::seconds(1));
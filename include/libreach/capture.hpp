@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace libreach::protocol
+{
+
+/// The direction in which captured bytes travelled.
+enum class CaptureDirection : std::uint8_t
+{
+  RECEIVED = 0x00,
+  TRANSMITTED = 0x01,
+};
+
+/// A chunk of bytes read from a capture. The data is only valid for as long as the reader that it was read from.
+struct CaptureRecord
+{
+  // Time at which the bytes were received or transmitted (steady clock)
+  std::chrono::nanoseconds timestamp;
+
+  CaptureDirection direction;
+
+  // Whether the bytes were received as a single datagram
+  bool datagram;
+
+  std::span<const std::uint8_t> data;
+};
+
+/// Record chunks of bytes to an append-only, memory-mapped capture file. Each chunk is stored with the time that it was
+/// recorded so that it can be replayed with its original timing. The writer is not thread-safe.
+class CaptureWriter
+{
+public:
+  /// Create a new capture file at the given path, replacing any existing file.
+  explicit CaptureWriter(const std::string & path);
+
+  CaptureWriter(const CaptureWriter &) = delete;
+  auto operator=(const CaptureWriter &) -> CaptureWriter & = delete;
+
+  /// Truncate the file to the recorded data and close it.
+  ~CaptureWriter();
+
+  /// Record a chunk of bytes. Returns false if the file could not be grown to store the chunk.
+  auto record(CaptureDirection direction, std::span<const std::uint8_t> data, bool datagram = false) -> bool;
+
+  /// Get the number of bytes of the file that have been used.
+  [[nodiscard]] auto size() const -> std::size_t { return size_; }
+
+private:
+  /// Grow the file and its mapping so that it can store at least the given number of bytes.
+  auto reserve(std::size_t capacity) -> bool;
+
+  int handle_;
+  std::uint8_t * data_{nullptr};
+  std::size_t size_{0};
+  std::size_t capacity_{0};
+};
+
+/// Read the records of a capture file in the order that they were recorded.
+class CaptureReader
+{
+public:
+  /// Open the capture file at the given path.
+  explicit CaptureReader(const std::string & path);
+
+  CaptureReader(const CaptureReader &) = delete;
+  auto operator=(const CaptureReader &) -> CaptureReader & = delete;
+
+  ~CaptureReader();
+
+  /// Read the next record, if there is one.
+  auto next() -> std::optional<CaptureRecord>;
+
+  /// Return to the first record.
+  auto rewind() -> void;
+
+private:
+  const std::uint8_t * data_{nullptr};
+  std::size_t size_{0};
+  std::size_t offset_{0};
+};
+
+}  // namespace libreach::protocol
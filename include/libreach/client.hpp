@@ -25,40 +25,133 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
-#include <deque>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <thread>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
+#include "libreach/capture.hpp"
 #include "libreach/packet.hpp"
+#include "libreach/reactor.hpp"
+#include "libreach/stream_decoder.hpp"
 
 namespace libreach::protocol
 {
 
+class IoUring;
+
+/// The maximum number of bytes written to a connection at once when sending a batch of packets. This is the largest
+/// UDP payload that fits in a standard 1500-byte Ethernet frame, so each write is sent as a single datagram.
+const std::size_t MAX_WRITE_SIZE = 1472;
+
 class Client
 {
 public:
-  /// Create a new client given a packet callback and a session timeout.
-  Client(std::function<void(const std::vector<Packet> &)> && callback, std::chrono::seconds session_timeout);
+  /// Create a new client given a packet callback, a session timeout, and the reactor used to service the connection.
+  /// If no reactor is provided, the reactor shared by all clients is used. If no packet callback is provided, received
+  /// packets are dropped until one is set using set_packet_callback.
+  ///
+  /// The client is disconnected as soon as no heartbeat has been received for the session timeout. By default, the
+  /// heartbeat frequency is chosen so that three heartbeats are expected within each session timeout.
+  Client(
+    std::function<void(PacketView)> && callback,
+    std::chrono::milliseconds session_timeout,
+    std::shared_ptr<Reactor> reactor = nullptr);
 
   /// Destructor.
-  virtual ~Client() = default;
+  virtual ~Client();
+
+  /// Get the file descriptor of the underlying connection.
+  [[nodiscard]] virtual auto native_handle() const -> int = 0;
 
   /// Check if the client is connected to the robot and running.
   [[nodiscard]] auto connected() const -> bool;
 
+  /// Set the packet callback of a client that was created without one, e.g., once the object that the callback refers
+  /// to has been constructed. The callback can only be set once.
+  auto set_packet_callback(std::function<void(PacketView)> && callback) -> void;
+
+  /// Set a callback that receives the packets decoded from each read of the connection together, instead of a packet
+  /// callback. Only one of the callbacks can be set, and it can only be set once.
+  auto set_packet_batch_callback(std::function<void(std::span<const Packet>)> && callback) -> void;
+
+  /// Check whether the packet callback has been set.
+  [[nodiscard]] auto has_packet_callback() const -> bool;
+
+  /// Register a callback that is executed when the client connects (true) or disconnects (false). Disconnects are
+  /// reported from the reactor thread once the session timeout has passed without a heartbeat.
+  auto register_connection_callback(std::function<void(bool)> && callback) -> void;
+
+  /// Get the session timeout.
+  [[nodiscard]] auto session_timeout() const -> std::chrono::milliseconds { return session_timeout_; }
+
+  /// Set the frequency (Hz) at which the robot sends heartbeats. The frequency should allow at least two heartbeats
+  /// to be received within the session timeout.
+  virtual auto set_heartbeat_frequency(std::uint8_t frequency) -> void;
+
+  /// Get the frequency (Hz) at which the robot sends heartbeats.
+  [[nodiscard]] auto heartbeat_frequency() const -> std::uint8_t;
+
+  /// Get the statistics of the data received from the connection, e.g., the number of frames lost to corruption.
+  [[nodiscard]] auto decode_statistics() const -> DecodeStatistics;
+
   /// Send a packet to the connected device.
   auto send_packet(const Packet & packet) const -> void;
 
+  /// Send multiple packets to the connected device. The packets are encoded back-to-back and written in as few writes
+  /// as possible (one write per MAX_WRITE_SIZE bytes).
+  auto send_packets(std::span<const Packet> packets) const -> void;
+
+  /// Send the packets returned by make_packet(i) for each i in [0, n_packets). Each packet is encoded into the write
+  /// buffer as soon as it is made, so the packets do not need to be stored first.
+  template <typename MakePacket>
+  auto send_packets(std::size_t n_packets, MakePacket && make_packet) const -> void;
+
+  /// Record the bytes received from and transmitted to the connection to a capture file at the given path, replacing
+  /// any capture that is in progress. Captures can be replayed using a ReplayClient.
+  auto start_capture(const std::string & path) -> void;
+
+  /// Stop recording the bytes received from and transmitted to the connection.
+  auto stop_capture() -> void;
+
 protected:
-  /// Start polling the connection; this should be called in the constructor of a derived class after connection.
+  /// Start polling the connection; this should be called in the constructor of a derived class after connection. Reads
+  /// are only performed once the connection has data available, so they should not block.
   auto start_polling_connection(std::uint16_t max_bytes_to_read) -> void;
 
+  /// Stop polling the connection, e.g., after the remote end has closed it. This does nothing if the connection is not
+  /// being polled.
+  auto stop_polling_connection() -> void;
+
+  /// Handle the loss of the connection (e.g., the remote end hung up) by disconnecting and attempting to reopen the
+  /// connection with an exponential backoff. This must be called from the reactor thread.
+  auto lose_connection() -> void;
+
   /// Shutdown the client; this should be called in the destructor of a derived class before the connection is closed.
   auto shutdown_client() -> void;
 
+  /// Decode bytes received from the connection. A datagram is self-contained, so a frame that is incomplete at the end
+  /// of a datagram is dropped instead of being completed by the next datagram.
+  auto receive_bytes(std::span<const std::uint8_t> bytes, bool datagram = false) -> void;
+
+  /// Get the buffer that the data read from the connection is stored in when the connection is polled without an
+  /// io_uring; this holds the maximum number of bytes to read on each poll.
+  [[nodiscard]] auto read_buffer() -> std::span<std::uint8_t> { return read_buffer_; }
+
+  /// Handle a packet that was decoded from the connection: heartbeats are recorded and the packet callback is executed.
+  auto receive_packet(PacketView packet) -> void;
+
+  /// Write data to the connection of another client, e.g., a transport that this client sends its data over.
+  static auto forward_bytes(const Client & client, std::span<const std::uint8_t> data) -> ssize_t;
+
 private:
   enum class ConnectionState : std::uint8_t
   {
@@ -75,36 +168,151 @@ private:
   /// Set the heartbeat frequency.
   auto set_heartbeat_rate(std::uint8_t frequency) const -> void;
 
-  /// Set the timestamp that the last heartbeat was received.
-  auto set_last_heartbeat(std::chrono::time_point<std::chrono::steady_clock> t) -> void;
+  /// Record that a heartbeat was received and push back the session deadline.
+  auto receive_heartbeat() -> void;
+
+  /// Check whether the session timeout has passed since the last heartbeat; this is executed at the session deadline.
+  auto check_heartbeat() -> void;
+
+  /// Report a change of the connection state.
+  auto notify_connection_state(ConnectionState connection_state) -> void;
+
+  /// Attempt to restore the connection; this is executed by the reconnect timer until heartbeats are received again.
+  /// A connection that was lost is reopened, otherwise the heartbeat configuration is sent again in case the robot was
+  /// restarted.
+  auto reconnect() -> void;
+
+  /// Close the underlying connection and start reopening it; this throws if the connection cannot be reopened (yet). By
+  /// default, connections cannot be reopened. Returns false if the connection is still being opened, in which case
+  /// finish_reopening_connection is called once the connection can be written to.
+  virtual auto reopen_connection() -> bool;
 
-  /// Check the heartbeat to ensure that the connection is still active.
-  auto check_heartbeat(std::chrono::seconds timeout) -> void;
+  /// Finish opening a connection that reopen_connection started opening; this throws if the connection could not be
+  /// opened.
+  virtual auto finish_reopening_connection() -> void;
 
-  /// Poll incoming data from the connection.
-  auto poll_connection(std::uint16_t max_bytes_to_read) -> void;
+  /// Finish reopening the connection once it can be written to; this is executed by the reactor.
+  auto finish_reopening() -> void;
 
-  /// Read a specified number of bytes from the connection and push them onto the queue.
-  virtual auto read_bytes(std::deque<std::uint8_t> & buffer, std::size_t n_bytes) const -> ssize_t = 0;
+  /// Resume polling the connection once it has been reopened.
+  auto restore_connection() -> void;
+
+  /// Check whether data can be written to the connection without blocking.
+  [[nodiscard]] auto connection_writable() const -> bool;
+
+  /// Read and decode the data that is available on the connection.
+  auto poll_connection(bool hangup) -> void;
+
+  /// Decode and dispatch the completed reads of the io_uring.
+  auto poll_io_uring() -> void;
+
+  /// Record bytes to the capture file, if a capture is in progress.
+  auto capture_bytes(CaptureDirection direction, std::span<const std::uint8_t> bytes, bool datagram) const -> void;
+
+  /// Write data to the connection, using the io_uring if one is available.
+  auto write_bytes(std::span<const std::uint8_t> data) const -> ssize_t;
+
+  /// Read the data that is available on the connection and pass it to receive_bytes. By default, this performs a single
+  /// read_bytes call; connections can override this to receive data in batches.
+  virtual auto read_available() -> void;
+
+  /// Handle the connection reporting a hang-up or an error while it is polled. By default, the connection is lost;
+  /// connectionless sockets override this because their errors (e.g., an ICMP port unreachable) are transient.
+  virtual auto handle_hangup() -> void;
+
+  /// Read up to buffer.size() bytes from the connection into a buffer.
+  virtual auto read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t = 0;
 
   /// Write data to a connection.
-  virtual auto write_to_connection(const std::vector<std::uint8_t> & data) const -> ssize_t = 0;
+  virtual auto write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t = 0;
 
-  // Callback to execute when new packet(s) are received.
-  std::function<void(const std::vector<Packet> &)> packet_callback_;
+  // Callback to execute when a new packet is received. The callback is not modified once it has been set, so the flag
+  // is the only synchronization needed to dispatch packets.
+  std::function<void(PacketView)> packet_callback_;
+  std::function<void(std::span<const Packet>)> packet_batch_callback_;
+  std::atomic<bool> packet_callback_set_{false};
 
   std::atomic<bool> running_{false};
 
-  // Monitor heartbeat messages from the robot to verify that the connection is still active.
-  std::thread heartbeat_monitor_thread_;
+  // The reactor services the connection and heartbeat timer so that clients do not need threads of their own.
+  std::shared_ptr<Reactor> reactor_;
+
+  // Monitor heartbeat messages from the robot to verify that the connection is still active. The timer expires once
+  // the session timeout has passed since the last heartbeat; each heartbeat pushes the deadline back.
+  std::chrono::milliseconds session_timeout_;
+  std::atomic<std::uint8_t> heartbeat_frequency_;
+  int heartbeat_timer_{-1};
   std::chrono::time_point<std::chrono::steady_clock> last_heartbeat_;
   mutable std::mutex last_heartbeat_lock_;
 
-  mutable std::mutex connection_state_lock_;
-  ConnectionState connection_state_{ConnectionState::DISCONNECTED};
+  std::function<void(bool)> connection_callback_;
+  std::mutex connection_callback_lock_;
+
+  // The file descriptor registered with the reactor, if any.
+  std::atomic<int> polling_handle_{-1};
+  std::uint16_t max_bytes_to_read_{0};
+
+  // Reconnection is attempted with an exponential backoff; this is only accessed by the reactor thread.
+  int reconnect_timer_{-1};
+  std::chrono::milliseconds reconnect_delay_;
+  bool connection_lost_{false};
+
+  // The connection that is being reopened without blocking the reactor thread, if any.
+  std::atomic<int> reopening_handle_{-1};
+
+  // Writes hold the lock in shared mode so that the connection cannot be reopened while it is being written to.
+  mutable std::shared_mutex connection_lock_;
 
-  // Thread used to read incoming data.
-  std::thread polling_thread_;
+  // When built with io_uring support, reads and writes are performed using an io_uring if the kernel supports it. This
+  // is shared so that the ring only needs to be a complete type when io_uring support is enabled.
+  std::shared_ptr<IoUring> io_uring_;
+
+  // Incoming data is only accessed by the reactor thread.
+  std::vector<std::uint8_t> read_buffer_;
+  StreamDecoder decoder_;
+
+  // With a batch callback, the packets decoded from a read are collected until the whole read has been decoded.
+  std::vector<Packet> received_packets_;
+  bool decoding_{false};
+
+  // A copy of the receive statistics that can be read from other threads.
+  DecodeStatistics decode_statistics_;
+  mutable std::mutex decode_statistics_lock_;
+
+  // Bytes are recorded while a capture is in progress; the flag avoids taking the lock when there is no capture.
+  mutable std::atomic<bool> capturing_{false};
+  mutable std::unique_ptr<CaptureWriter> capture_;
+  mutable std::mutex capture_lock_;
+
+  // The connection state is checked before every transmission, so it is read without taking a lock.
+  std::atomic<ConnectionState> connection_state_{ConnectionState::DISCONNECTED};
 };
 
+template <typename MakePacket>
+auto Client::send_packets(std::size_t n_packets, MakePacket && make_packet) const -> void
+{
+  static_assert(MAX_WRITE_SIZE >= MAX_ENCODED_PACKET_SIZE, "A write must be able to store at least one packet.");
+
+  std::array<std::uint8_t, MAX_WRITE_SIZE> buffer;
+  std::size_t buffer_size = 0;
+
+  const auto flush = [this, &buffer, &buffer_size] {
+    if (write_bytes(std::span(buffer).first(buffer_size)) < 0) {
+      throw std::runtime_error("Failed to send packets; the connection was likely lost.");
+    }
+    buffer_size = 0;
+  };
+
+  for (std::size_t i = 0; i < n_packets; ++i) {
+    if (buffer.size() - buffer_size < MAX_ENCODED_PACKET_SIZE) {
+      flush();
+    }
+    buffer_size += encode_packet_into(make_packet(i), std::span(buffer).subspan(buffer_size));
+  }
+
+  if (buffer_size > 0) {
+    flush();
+  }
+}
+
 }  // namespace libreach::protocol
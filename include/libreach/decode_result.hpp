@@ -0,0 +1,110 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace libreach::protocol
+{
+
+/// The reasons that a frame can fail to decode.
+enum class DecodeError : std::uint8_t
+{
+  EMPTY_FRAME,
+  INVALID_ENCODING,
+  TOO_SHORT,
+  TOO_LONG,
+  CRC_MISMATCH,
+  LENGTH_MISMATCH,
+};
+
+/// Get a human-readable description of a decode error.
+constexpr auto to_string(DecodeError error) -> std::string_view
+{
+  switch (error) {
+    case DecodeError::EMPTY_FRAME:
+      return "Cannot decode an empty byte stream.";
+    case DecodeError::INVALID_ENCODING:
+      return "Failed to decode the encoded data.";
+    case DecodeError::TOO_SHORT:
+      return "Decoded data is too short to contain a packet.";
+    case DecodeError::TOO_LONG:
+      return "Encoded data is too long to contain a packet.";
+    case DecodeError::CRC_MISMATCH:
+      return "The expected and actual CRC values do not match.";
+    case DecodeError::LENGTH_MISMATCH:
+      return "The specified payload size is not equal to the actual payload size.";
+  }
+  return "Unknown decode error.";
+}
+
+/// The result of a non-throwing decode: either the decoded value or the reason that decoding failed. The interface
+/// mirrors std::expected so that it can be replaced once the library moves to C++23.
+template <typename T>
+class DecodeResult
+{
+public:
+  DecodeResult(T value)  // NOLINT(google-explicit-constructor)
+  : result_(std::move(value))
+  {
+  }
+
+  DecodeResult(DecodeError error)  // NOLINT(google-explicit-constructor)
+  : result_(error)
+  {
+  }
+
+  /// Check whether decoding succeeded.
+  [[nodiscard]] auto has_value() const -> bool { return std::holds_alternative<T>(result_); }
+
+  explicit operator bool() const { return has_value(); }
+
+  /// Get the decoded value; this throws if decoding failed.
+  [[nodiscard]] auto value() const -> const T &
+  {
+    if (!has_value()) {
+      throw std::runtime_error(std::string(to_string(error())));
+    }
+    return std::get<T>(result_);
+  }
+
+  /// Get the reason that decoding failed. This should only be called if decoding failed.
+  [[nodiscard]] auto error() const -> DecodeError { return std::get<DecodeError>(result_); }
+
+  [[nodiscard]] auto operator*() const -> const T & { return *std::get_if<T>(&result_); }
+
+  [[nodiscard]] auto operator->() const -> const T * { return std::get_if<T>(&result_); }
+
+private:
+  std::variant<T, DecodeError> result_;
+};
+
+}  // namespace libreach::protocol
@@ -25,8 +25,8 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
-#include <boost/circular_buffer.hpp>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
@@ -35,26 +35,78 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <span>
+#include <string>
 #include <thread>
-#include <unordered_map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "libreach/client.hpp"
 #include "libreach/mode.hpp"
 #include "libreach/packet.hpp"
 #include "libreach/packet_id.hpp"
+#include "libreach/packet_schema.hpp"
 
 namespace libreach
 {
 
+/// The method used by a driver to write outgoing packets to its client.
+enum class TransmitMode : std::uint8_t
+{
+  /// Packets are written on the calling thread before the send method returns.
+  SYNCHRONOUS,
+
+  /// Packets are added to a lock-free queue and written in batches by a dedicated writer thread, so the send methods
+  /// never block on I/O. Commands are written before any queued REQUEST packets.
+  ASYNCHRONOUS,
+};
+
+/// The method used by a driver to distribute received packets to its worker threads.
+enum class DispatchMode : std::uint8_t
+{
+  /// Packets are processed by whichever worker is available first. With multiple workers, the callbacks for two
+  /// packets from the same device may be executed out of order.
+  ANY_WORKER,
+
+  /// The packets from each device are always processed by the same worker, so they are processed in the order that
+  /// they were received while different devices are processed in parallel.
+  PER_DEVICE,
+
+  /// The packets with each combination of device ID and packet ID are always processed by the same worker, e.g., the
+  /// POSITION updates of a joint are processed in order, but may be processed in parallel with its VELOCITY updates.
+  PER_DEVICE_AND_PACKET,
+};
+
+/// The largest number of workers that packets can be dispatched to per device (or per device and packet ID); each of
+/// these workers has a queue of its own.
+const std::size_t MAX_ORDERED_WORKERS = 64;
+
+/// Identifies a callback registered with a driver.
+struct CallbackHandle
+{
+  PacketId packet_id;
+  std::uint64_t id;
+};
+
 class ReachDriver
 {
 public:
   /// Create a new base driver using:
-  ///   - a client (e.g., serial or TCP) for communication,
-  ///   - a queue size for storing incoming packets,
-  ///   - a number of worker threads for processing incoming packets.
-  ReachDriver(std::unique_ptr<protocol::Client> client, std::size_t q_size, std::size_t n_workers);
+  ///   - a client (e.g., serial or TCP) for communication, which should be created without a packet callback,
+  ///   - a queue size for storing incoming packets (rounded up to a power of two; each worker has a queue of this size
+  ///     unless any worker can process any packet),
+  ///   - a number of worker threads for processing incoming packets (at most MAX_ORDERED_WORKERS unless any worker can
+  ///     process any packet),
+  ///   - the method used to write outgoing packets,
+  ///   - the method used to distribute incoming packets to the workers.
+  ReachDriver(
+    std::unique_ptr<protocol::Client> client,
+    std::size_t q_size,
+    std::size_t n_workers,
+    TransmitMode transmit_mode = TransmitMode::SYNCHRONOUS,
+    DispatchMode dispatch_mode = DispatchMode::ANY_WORKER);
 
   /// Set the operating mode of a device.
   auto set_mode(std::uint8_t device_id, Mode mode) const -> void;
@@ -62,9 +114,17 @@ public:
   /// Set the desired velocity of a device (rad/s for rotational joints, mm/s for linear).
   auto set_velocity(std::uint8_t device_id, float velocity) const -> void;
 
+  /// Set the desired velocities of multiple devices from (device ID, velocity) pairs. The commands are sent in
+  /// a single write to minimize the delay between devices.
+  auto set_velocity(std::span<const std::pair<std::uint8_t, float>> velocities) const -> void;
+
   /// Set the desired position of a device ([0, 2π] rad for rotational joints, mm for linear).
   auto set_position(std::uint8_t device_id, float position) const -> void;
 
+  /// Set the desired positions of multiple devices from (device ID, position) pairs. The commands are sent in
+  /// a single write to minimize the delay between devices.
+  auto set_position(std::span<const std::pair<std::uint8_t, float>> positions) const -> void;
+
   /// Set the desired relative position of a device ([0, 2π] rad for rotational joints, mm for linear).
   auto set_relative_position(std::uint8_t device_id, float relative_position) const -> void;
 
@@ -93,23 +153,62 @@ public:
   auto request_at_rate(const std::vector<PacketId> & packet_ids, std::uint8_t device_id, std::chrono::milliseconds rate)
     const -> void;
 
-  /// Register a callback for a specific packet ID.
-  auto register_callback(PacketId packet_id, std::function<void(const Packet &)> && callback) -> void;
+  /// Get the statistics of the data received by the client, e.g., the number of frames lost to corruption.
+  [[nodiscard]] auto decode_statistics() const -> protocol::DecodeStatistics;
 
-  /// Send a packet using the configured client.
+  /// Register a callback that is executed when the client connects (true) or disconnects (false), e.g., to stop
+  /// commanding the robot as soon as the session timeout passes without a heartbeat.
+  auto register_connection_callback(std::function<void(bool)> && callback) const -> void;
+
+  /// Set the frequency (Hz) at which the robot sends heartbeats.
+  auto set_heartbeat_frequency(std::uint8_t frequency) const -> void;
+
+  /// Record the bytes received and transmitted by the client to a capture file, which can be replayed offline using a
+  /// ReplayDriver.
+  auto start_capture(const std::string & path) const -> void;
+
+  /// Stop recording the bytes received and transmitted by the client.
+  auto stop_capture() const -> void;
+
+  /// Register a callback for a specific packet ID. Callbacks may be registered while packets are being received, in
+  /// which case this waits for the workers to finish any callbacks that they are running. The returned handle can be
+  /// used to unregister the callback.
+  auto register_callback(PacketId packet_id, std::function<void(PacketView)> && callback) -> CallbackHandle;
+
+  /// Register a typed callback for a specific packet ID. The callback is invoked with the device ID followed by the
+  /// fields defined by the packet's schema, e.g., `[](std::uint8_t device_id, float position) { ... }` for POSITION.
+  /// Packets whose data does not match the schema are dropped.
+  template <PacketId Id, typename Callback>
+  auto register_callback(Callback && callback) -> CallbackHandle;
+
+  /// Unregister a callback. Once this returns, the callback is not running and will not be executed again (unless
+  /// this is called from a callback, in which case the current invocation may still be running). Unregistering a
+  /// callback that has already been unregistered does nothing.
+  auto unregister_callback(CallbackHandle handle) -> void;
+
+  /// Send a packet using the configured client. In the asynchronous transmit mode, this throws if the transmit queue
+  /// is full.
   auto send_packet(const Packet & packet) const -> void;
 
   /// Send a packet using the configured client.
   auto send_packet(PacketId packet_id, std::uint8_t device_id, const std::vector<std::uint8_t> & data) const -> void;
 
+  /// Send multiple packets using the configured client. The packets are encoded back-to-back and written together.
+  /// In the asynchronous transmit mode, this throws without queueing any of the packets if the transmit queue does not
+  /// have space for all of them.
+  auto send_packets(std::span<const Packet> packets) const -> void;
+
+  /// Send a packet whose data is serialized according to its schema.
+  ///
+  /// e.g., `driver.send_packet<PacketId::POSITION>(0x01, 1.0F)`
+  template <PacketId Id, typename... Args>
+  auto send_packet(std::uint8_t device_id, const Args &... fields) const -> void;
+
 protected:
   ~ReachDriver();
 
-  /// Callback executed when a packet is received by a client.
-  auto receive_packet(const Packet & packet) -> void;
-
-  /// Callback executed when multiple packets have been received by a client.
-  auto receive_packets(const std::vector<Packet> & packets) -> void;
+  /// Callback executed with the packets that a client has decoded from a read of its connection.
+  auto receive_packets(std::span<const Packet> packets) -> void;
 
   std::unique_ptr<protocol::Client> client_;
 
@@ -128,18 +227,48 @@ private:
     std::chrono::time_point<std::chrono::steady_clock> next_request;
   };
 
-  /// Process the first packet in the packet queue.
-  auto process_packet() -> void;
+  struct PacketQueue;
+  struct ReaderEpoch;
+
+  /// Get the index of the packet queue that a received packet is added to.
+  [[nodiscard]] auto queue_index(PacketView packet) const -> std::size_t;
+
+  /// Add a received packet to a packet queue and make it available to the workers without waking them.
+  auto enqueue_packet(PacketQueue & queue, const Packet & packet) -> void;
+
+  /// Wake up the workers of a packet queue to process the given number of packets that have been added to it.
+  auto notify_workers(PacketQueue & queue, std::uint32_t n_packets) -> void;
+
+  /// Process the first packet in a packet queue using the epoch of the calling worker.
+  auto process_packet(PacketQueue & queue, ReaderEpoch & epoch) -> void;
 
   /// Process the requests.
   auto process_requests() -> void;
 
+  /// Write the packets in the transmit queue to the client.
+  auto process_transmit_queue() -> void;
+
+  /// Write packets to the client on the calling thread.
+  auto write_packets(std::span<const Packet> packets) const -> void;
+
+  /// Reserve space in the transmit queue for a batch of commands and requests, so that either every packet in the
+  /// batch is queued or none are; this throws if the queue does not have space for the whole batch.
+  auto reserve_transmit_queue(std::size_t n_commands, std::size_t n_requests) const -> void;
+
+  /// Add a packet to the transmit queue using space that has already been reserved for it.
+  auto queue_packet(const Packet & packet) const -> void;
+
+  /// Send a single-float command to each of the provided devices in one batch.
+  template <PacketId Id>
+  auto send_commands(std::span<const std::pair<std::uint8_t, float>> commands) const -> void;
+
   std::atomic<bool> running_{false};
 
-  // Packets are stored to a circular buffer to avoid limit the amount of old data stored.
-  boost::circular_buffer<Packet> packets_;
-  std::mutex packets_lock_;
-  std::condition_variable packets_cv_;
+  // Received packets are passed to the workers through lock-free queues; the oldest packet is dropped when a queue is
+  // full to limit the amount of old data stored. All workers share a single queue unless packets are dispatched by
+  // device, in which case each worker has a queue of its own.
+  DispatchMode dispatch_mode_;
+  std::vector<std::unique_ptr<PacketQueue>> packet_queues_;
   std::vector<std::thread> packet_threads_;
 
   // Requests are managed by a scheduler to ensure that they are sent at the correct rate.
@@ -148,10 +277,71 @@ private:
   mutable std::condition_variable request_cv_;
   std::thread request_scheduler_thread_;
 
+  // Requests that are due are sent together; this is only accessed by the request scheduler.
+  std::vector<Packet> due_requests_;
+
   // We need to manage access to the client to account for the request scheduler, which runs in its own thread.
   mutable std::mutex send_packet_lock_;
 
-  std::unordered_map<PacketId, std::vector<std::function<void(Packet)>>> callbacks_;
+  // Outgoing packets are only queued in the asynchronous transmit mode.
+  struct TransmitQueue;
+  std::unique_ptr<TransmitQueue> transmit_queue_;
+  std::thread writer_thread_;
+
+  // Callbacks are stored in a table indexed by the packet ID. Each entry points to an immutable list of subscribers
+  // that is replaced (copy-on-write) when a callback is registered or unregistered, so the workers never take a lock
+  // to dispatch a packet. A replaced list is retired and only deleted once no worker can still be reading it.
+  struct Subscriber
+  {
+    std::uint64_t id;
+    std::function<void(PacketView)> callback;
+  };
+
+  using Subscribers = std::vector<Subscriber>;
+
+  // Each worker increments its epoch before and after dispatching a packet, so the epoch is odd while the worker may be
+  // reading the callback table.
+  struct alignas(64) ReaderEpoch
+  {
+    std::atomic<std::uint64_t> value{0};
+  };
+
+  /// Publish a new list of subscribers for a packet ID. This must be called while holding the callbacks lock.
+  auto publish_callbacks(PacketId packet_id, std::unique_ptr<const Subscribers> subscribers) -> void;
+
+  /// Wait for the workers that are dispatching a packet to finish, then delete the retired subscriber lists. This does
+  /// nothing when called from a worker, which would otherwise wait for itself.
+  auto reclaim_callbacks() -> void;
+
+  std::array<std::atomic<const Subscribers *>, 256> callbacks_{};
+  std::vector<ReaderEpoch> reader_epochs_;
+
+  // The subscriber lists are owned separately from the table read by the workers; these are only accessed while
+  // holding the callbacks lock.
+  std::array<std::unique_ptr<const Subscribers>, 256> subscribers_;
+  std::vector<std::unique_ptr<const Subscribers>> retired_subscribers_;
+  std::uint64_t next_callback_id_{0};
+  std::mutex callbacks_lock_;
 };
 
+template <PacketId Id, typename Callback>
+auto ReachDriver::register_callback(Callback && callback) -> CallbackHandle
+{
+  static_assert(
+    is_packet_callback_v<Id, std::decay_t<Callback>>,
+    "The callback must accept the device ID followed by the fields defined by the packet's schema.");
+
+  return register_callback(Id, [callback = std::forward<Callback>(callback)](PacketView packet) mutable {
+    if (auto fields = PacketSchema<Id>::decode(packet.data())) {
+      std::apply([&callback, &packet](const auto &... field) { callback(packet.device_id(), field...); }, *fields);
+    }
+  });
+}
+
+template <PacketId Id, typename... Args>
+auto ReachDriver::send_packet(std::uint8_t device_id, const Args &... fields) const -> void
+{
+  send_packet(make_packet<Id>(device_id, fields...));
+}
+
 }  // namespace libreach
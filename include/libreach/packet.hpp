@@ -25,45 +25,97 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
-#include <memory>
+#include <cstring>
+#include <initializer_list>
+#include <span>
 #include <stdexcept>
 #include <vector>
 
+#include "libreach/decode_result.hpp"
 #include "libreach/packet_id.hpp"
 
 namespace libreach
 {
 
+class PacketView;
+
+/// The maximum number of data bytes that a packet can hold. The encoded length field is a single byte that also
+/// accounts for the packet ID, device ID, length, and CRC bytes.
+const std::size_t MAX_PACKET_DATA_SIZE = 0xFF - 4;
+
+/// A packet that stores its data inline. Packets are trivially copyable, so they can be queued without allocating.
 class Packet
 {
 public:
   /// Create a new packet given the packet ID, device ID, and (unencoded) data.
-  Packet(PacketId packet_id, std::uint8_t device_id, std::vector<std::uint8_t> data);
+  Packet(PacketId packet_id, std::uint8_t device_id, std::span<const std::uint8_t> data);
+
+  /// Create a new packet given the packet ID, device ID, and a list of (unencoded) bytes.
+  Packet(PacketId packet_id, std::uint8_t device_id, std::initializer_list<std::uint8_t> data);
+
+  /// Create a new packet that owns a copy of the data referenced by a packet view.
+  explicit Packet(const PacketView & view);
 
   [[nodiscard]] auto packet_id() const -> PacketId;
 
   [[nodiscard]] auto device_id() const -> std::uint8_t;
 
-  [[nodiscard]] auto data() const -> std::vector<std::uint8_t>;
+  [[nodiscard]] auto data() const -> std::span<const std::uint8_t>;
 
   [[nodiscard]] auto data_size() const -> std::size_t;
 
 private:
   PacketId packet_id_;
   std::uint8_t device_id_;
-  std::vector<std::uint8_t> data_;
+  std::uint8_t data_size_;
+  std::array<std::uint8_t, MAX_PACKET_DATA_SIZE> data_;
+};
+
+/// A non-owning view of a packet. The view is only valid for as long as the data that it references.
+class PacketView
+{
+public:
+  /// Create a new packet view given the packet ID, device ID, and (unencoded) data.
+  PacketView(PacketId packet_id, std::uint8_t device_id, std::span<const std::uint8_t> data)
+  : packet_id_(packet_id),
+    device_id_(device_id),
+    data_(data)
+  {
+  }
+
+  /// Create a new packet view that references the data of an existing packet.
+  PacketView(const Packet & packet)  // NOLINT(google-explicit-constructor)
+  : PacketView(packet.packet_id(), packet.device_id(), packet.data())
+  {
+  }
+
+  [[nodiscard]] auto packet_id() const -> PacketId { return packet_id_; }
+
+  [[nodiscard]] auto device_id() const -> std::uint8_t { return device_id_; }
+
+  [[nodiscard]] auto data() const -> std::span<const std::uint8_t> { return data_; }
+
+  [[nodiscard]] auto data_size() const -> std::size_t { return data_.size(); }
+
+private:
+  PacketId packet_id_;
+  std::uint8_t device_id_;
+  std::span<const std::uint8_t> data_;
 };
 
 /// Deserialize a packet's data into a given type.
 template <typename T>
-[[nodiscard]] inline auto deserialize(const Packet & packet) -> T
+[[nodiscard]] inline auto deserialize(PacketView packet) -> T
 {
   if (packet.data_size() != sizeof(T)) {
     throw std::invalid_argument("Cannot deserialize packet data into the requested type due to mismatched sizes.");
   }
-  return *reinterpret_cast<const T *>(packet.data().data());
+  T value;
+  std::memcpy(&value, packet.data().data(), sizeof(T));
+  return value;
 }
 
 namespace protocol
@@ -72,14 +124,42 @@ namespace protocol
 /// The delimiter used to separate packets in a byte stream.
 const std::uint8_t PACKET_DELIMITER = 0x00;
 
+/// The maximum size of an encoded packet. An unencoded packet holds at most 255 bytes, which requires two COBS code
+/// bytes and the trailing delimiter once encoded.
+const std::size_t MAX_ENCODED_PACKET_SIZE = 0xFF + 3;
+
+/// Get the maximum size of a packet with a given amount of data once it has been encoded, including the delimiter.
+constexpr auto max_encoded_packet_size(std::size_t data_size) -> std::size_t
+{
+  // The packet ID, device ID, length, and CRC are appended to the data before it is COBS-encoded
+  const std::size_t decoded_size = data_size + 4;
+  return decoded_size + (decoded_size / 254) + 2;
+}
+
+static_assert(
+  max_encoded_packet_size(MAX_PACKET_DATA_SIZE) == MAX_ENCODED_PACKET_SIZE,
+  "The maximum encoded packet size must fit the largest packet.");
+
 /// Encode a packet into a byte stream.
 auto encode_packet(const Packet & packet) -> std::vector<std::uint8_t>;
 
-/// Decode a packet from a byte stream.
-auto decode_packet(const std::vector<std::uint8_t> & data) -> Packet;
+/// Encode a packet into a caller-provided buffer and return the number of bytes written. The CRC and COBS framing are
+/// computed in a single pass without allocating. The buffer should be able to store MAX_ENCODED_PACKET_SIZE bytes.
+auto encode_packet_into(const Packet & packet, std::span<std::uint8_t> out) -> std::size_t;
+
+/// Decode a packet from a byte stream. This throws if the data does not contain a valid packet.
+auto decode_packet(std::span<const std::uint8_t> data) -> Packet;
+
+/// Decode a packet from a byte stream, returning the reason that decoding failed instead of throwing.
+auto try_decode_packet(std::span<const std::uint8_t> data) -> DecodeResult<Packet>;
+
+/// Decode multiple packets from a byte stream. Each packet is decoded in place, so the returned views reference (and
+/// are only valid for as long as) the provided buffer. Frames that fail to decode are reported and skipped.
+auto decode_packets(std::span<std::uint8_t> data) -> std::vector<PacketView>;
 
-/// Decode multiple packets from a byte stream.
-auto decode_packets(const std::vector<std::uint8_t> & data) -> std::vector<Packet>;
+/// Decode multiple packets from a byte stream in place without throwing. One result is returned for each complete
+/// frame in the order that the frames appear; bytes that follow the final delimiter are ignored.
+auto try_decode_packets(std::span<std::uint8_t> data) -> std::vector<DecodeResult<PacketView>>;
 
 }  // namespace protocol
 
@@ -0,0 +1,159 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "libreach/mode.hpp"
+#include "libreach/packet.hpp"
+#include "libreach/packet_id.hpp"
+
+namespace libreach
+{
+
+/// The layout of a packet's data, described as a sequence of fixed-size fields that are packed without padding.
+template <typename... Fields>
+struct PacketFields
+{
+  static_assert(sizeof...(Fields) > 0, "A packet must contain at least one field.");
+  static_assert((std::is_trivially_copyable_v<Fields> && ...), "Packet fields must be trivially copyable.");
+
+  using tuple_type = std::tuple<Fields...>;
+
+  /// The number of bytes occupied by the fields.
+  static constexpr std::size_t SIZE = (sizeof(Fields) + ...);
+
+  /// Serialize the fields into their packed byte representation.
+  [[nodiscard]] static auto encode(const Fields &... fields) -> std::array<std::uint8_t, SIZE>
+  {
+    std::array<std::uint8_t, SIZE> bytes;
+    std::size_t offset = 0;
+    ((std::memcpy(bytes.data() + offset, &fields, sizeof(Fields)), offset += sizeof(Fields)), ...);
+    return bytes;
+  }
+
+  /// Deserialize the fields from their packed byte representation. Returns std::nullopt if the data has the wrong size.
+  [[nodiscard]] static auto decode(std::span<const std::uint8_t> data) -> std::optional<tuple_type>
+  {
+    if (data.size() != SIZE) {
+      return std::nullopt;
+    }
+
+    tuple_type fields;
+    std::size_t offset = 0;
+    std::apply(
+      [&data, &offset](auto &... field) {
+        ((std::memcpy(&field, data.data() + offset, sizeof(field)), offset += sizeof(field)), ...);
+      },
+      fields);
+
+    return fields;
+  }
+};
+
+/// A compile-time map from packet IDs to the layout of their data. Packets without a schema (e.g., those with a
+/// variable amount of data, such as REQUEST) can still be sent and received as raw bytes.
+template <PacketId Id>
+struct PacketSchema;
+
+using SixFloatFields = PacketFields<float, float, float, float, float, float>;
+using CylinderFields = PacketFields<float, float, float, float, float, float, float>;
+
+// clang-format off
+template <> struct PacketSchema<PacketId::MODE> : PacketFields<Mode> {};
+template <> struct PacketSchema<PacketId::VELOCITY> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::POSITION> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::CURRENT> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::RELATIVE_POSITION> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::INDEXED_POSITION> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::SERIAL_NUMBER> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::MODEL_NUMBER> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::TEMPERATURE> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::VOLTAGE> : PacketFields<float> {};
+template <> struct PacketSchema<PacketId::HEARTBEAT_FREQUENCY> : PacketFields<std::uint8_t> {};
+
+// Limits are specified as (minimum, maximum)
+template <> struct PacketSchema<PacketId::POSITION_LIMITS> : PacketFields<float, float> {};
+template <> struct PacketSchema<PacketId::VELOCITY_LIMITS> : PacketFields<float, float> {};
+template <> struct PacketSchema<PacketId::CURRENT_LIMITS> : PacketFields<float, float> {};
+
+// End effector poses and velocities are specified as (x, y, z, rz, ry, rx)
+template <> struct PacketSchema<PacketId::KM_END_POS> : SixFloatFields {};
+template <> struct PacketSchema<PacketId::KM_END_VEL> : SixFloatFields {};
+template <> struct PacketSchema<PacketId::KM_END_VEL_LOCAL> : SixFloatFields {};
+
+// Box obstacles are specified by two opposite corners as (x1, y1, z1, x2, y2, z2)
+template <> struct PacketSchema<PacketId::KM_BOX_OBSTACLE_02> : SixFloatFields {};
+template <> struct PacketSchema<PacketId::KM_BOX_OBSTACLE_03> : SixFloatFields {};
+template <> struct PacketSchema<PacketId::KM_BOX_OBSTACLE_04> : SixFloatFields {};
+template <> struct PacketSchema<PacketId::KM_BOX_OBSTACLE_05> : SixFloatFields {};
+
+// Cylinder obstacles are specified by the centers of their ends and a radius as (x1, y1, z1, x2, y2, z2, r)
+template <> struct PacketSchema<PacketId::KM_CYLINDER_OBSTACLE_02> : CylinderFields {};
+template <> struct PacketSchema<PacketId::KM_CYLINDER_OBSTACLE_03> : CylinderFields {};
+template <> struct PacketSchema<PacketId::KM_CYLINDER_OBSTACLE_04> : CylinderFields {};
+template <> struct PacketSchema<PacketId::KM_CYLINDER_OBSTACLE_05> : CylinderFields {};
+// clang-format on
+
+namespace detail
+{
+
+template <typename Callback, typename Fields>
+struct IsPacketCallback;
+
+template <typename Callback, typename... Fields>
+struct IsPacketCallback<Callback, std::tuple<Fields...>>
+: std::is_invocable<Callback &, std::uint8_t, const Fields &...>
+{
+};
+
+}  // namespace detail
+
+/// Whether a callback can be invoked with a device ID followed by the fields defined by a packet's schema.
+template <PacketId Id, typename Callback>
+inline constexpr bool is_packet_callback_v =
+  detail::IsPacketCallback<Callback, typename PacketSchema<Id>::tuple_type>::value;
+
+/// Create a packet whose data is serialized according to its schema.
+template <PacketId Id, typename... Args>
+[[nodiscard]] auto make_packet(std::uint8_t device_id, const Args &... fields) -> Packet
+{
+  static_assert(
+    std::is_invocable_v<decltype(&PacketSchema<Id>::encode), const Args &...>,
+    "The provided fields do not match the schema of the packet.");
+
+  const auto bytes = PacketSchema<Id>::encode(fields...);
+  return {Id, device_id, std::span<const std::uint8_t>(bytes)};
+}
+
+}  // namespace libreach
@@ -0,0 +1,121 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace libreach::protocol
+{
+
+/// An event loop that services many file descriptors and timers from a single thread using epoll and timerfd. All
+/// callbacks registered with a reactor are executed sequentially from the reactor's thread, so callbacks should not
+/// block.
+class Reactor
+{
+public:
+  /// Create a new reactor and start its thread.
+  Reactor();
+
+  /// Stop the reactor thread. All file descriptors and timers should be removed before the reactor is destroyed.
+  ~Reactor();
+
+  Reactor(const Reactor &) = delete;
+  auto operator=(const Reactor &) -> Reactor & = delete;
+
+  /// Get the reactor that is shared by all clients that were not created with a reactor of their own. The reactor is
+  /// created when it is first requested and destroyed once it is no longer referenced.
+  static auto shared() -> std::shared_ptr<Reactor>;
+
+  /// Execute a callback whenever a file descriptor has data available to read. The callback argument indicates whether
+  /// the other end of the connection hung up (e.g., a USB serial adapter was unplugged) or the connection has an error.
+  auto add_reader(int fd, std::function<void(bool)> && callback) -> void;
+
+  /// Execute a callback whenever a file descriptor can be written to, e.g., once a non-blocking connect has finished.
+  /// The callback argument indicates whether the connection hung up or has an error.
+  auto add_writer(int fd, std::function<void(bool)> && callback) -> void;
+
+  /// Execute a callback periodically and return the timer's identifier.
+  auto add_timer(std::chrono::nanoseconds period, std::function<void()> && callback) -> int;
+
+  /// Create a timer that executes a callback once its deadline passes and return the timer's identifier. The timer is
+  /// created without a deadline; use set_deadline to start it.
+  auto add_deadline(std::function<void()> && callback) -> int;
+
+  /// Set the deadline of a timer created by add_deadline to the given delay from now, replacing the current deadline.
+  /// This may be called from any thread.
+  auto set_deadline(int timer, std::chrono::nanoseconds delay) -> void;
+
+  /// Stop watching a file descriptor. Once this returns, the callback is not running and will not be executed again
+  /// (unless this is called from the callback itself).
+  auto remove_reader(int fd) -> void;
+
+  /// Stop watching a file descriptor added by add_writer; this provides the same guarantees as remove_reader.
+  auto remove_writer(int fd) -> void;
+
+  /// Stop and destroy a timer; this provides the same guarantees as remove_reader.
+  auto remove_timer(int timer) -> void;
+
+private:
+  /// Wait for events and dispatch them to their callbacks until the reactor is stopped.
+  auto run() -> void;
+
+  /// Watch a file descriptor for the given epoll events.
+  auto add(int fd, std::uint32_t events, std::function<void(bool)> && callback) -> void;
+
+  /// Stop watching a file descriptor and wait for any callback that is currently executing to finish.
+  auto remove(int fd) -> void;
+
+  /// Create a timer with the given initial expiration and period (zero for a one-shot timer) and register it.
+  auto create_timer(
+    std::chrono::nanoseconds expiration,
+    std::chrono::nanoseconds period,
+    std::function<void()> && callback) -> int;
+
+  int epoll_fd_;
+
+  // Written to when the reactor should wake up to be stopped.
+  int wakeup_fd_;
+
+  std::atomic<bool> running_{false};
+
+  // Callbacks are reference counted so that they can be removed while they are being executed.
+  std::unordered_map<int, std::shared_ptr<std::function<void(bool)>>> callbacks_;
+  std::mutex callbacks_lock_;
+
+  // Held by the reactor thread while it executes callbacks.
+  std::mutex dispatch_lock_;
+
+  std::thread reactor_thread_;
+};
+
+}  // namespace libreach::protocol
@@ -0,0 +1,153 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "libreach/client.hpp"
+
+namespace libreach::protocol
+{
+
+/// The method used to send packets over the transports of a redundant client.
+enum class RedundancyMode : std::uint8_t
+{
+  /// Packets are sent over both transports; whichever copy of a response arrives first is used.
+  BROADCAST,
+
+  /// Packets are only sent over the primary transport while it is connected, and over the secondary transport
+  /// otherwise.
+  FAILOVER,
+};
+
+/// Create a client given the packet callback that it should execute.
+using ClientFactory = std::function<std::unique_ptr<Client>(std::function<void(PacketView)> &&)>;
+
+/// The default time within which a packet received over one transport is considered a copy of the same packet
+/// received over the other transport.
+const std::chrono::milliseconds DEFAULT_DUPLICATE_WINDOW(50);
+
+/// A client that communicates with a device over two transports (e.g., a serial umbilical and an Ethernet link) and
+/// merges the packets that they receive. Each transport monitors its own connection and reconnects independently, so
+/// losing one transport costs no reconnection time.
+///
+/// A packet is dropped as a duplicate if a packet with the same device ID, packet ID, and data was received over the
+/// other transport within the duplicate window. Repeated packets received over the same transport are never dropped.
+class RedundantClient : public Client
+{
+public:
+  /// Create a new redundant client using
+  /// - a factory for the primary transport,
+  /// - a factory for the secondary transport,
+  /// - a packet callback,
+  /// - session timeout,
+  /// - the method used to send packets,
+  /// - the duplicate window,
+  /// - and the reactor used to service the heartbeat timer (defaults to the shared reactor).
+  RedundantClient(
+    const ClientFactory & primary,
+    const ClientFactory & secondary,
+    std::function<void(PacketView)> && callback,
+    std::chrono::milliseconds session_timeout,
+    RedundancyMode mode = RedundancyMode::BROADCAST,
+    std::chrono::milliseconds duplicate_window = DEFAULT_DUPLICATE_WINDOW,
+    std::shared_ptr<Reactor> reactor = nullptr);
+
+  ~RedundantClient() override;
+
+  /// The transports are serviced separately, so there is no single file descriptor; this is always -1.
+  [[nodiscard]] auto native_handle() const -> int override;
+
+  /// Set the frequency (Hz) at which the robot sends heartbeats over both transports.
+  auto set_heartbeat_frequency(std::uint8_t frequency) -> void override;
+
+  /// Check if the primary transport is connected to the robot.
+  [[nodiscard]] auto primary_connected() const -> bool;
+
+  /// Check if the secondary transport is connected to the robot.
+  [[nodiscard]] auto secondary_connected() const -> bool;
+
+  /// Get the number of packets that have been dropped as duplicates.
+  [[nodiscard]] auto duplicates_dropped() const -> std::uint64_t;
+
+private:
+  /// A packet that was recently received over one of the transports.
+  struct RecentPacket
+  {
+    std::uint64_t digest{0};
+    std::chrono::steady_clock::time_point received;
+    std::uint8_t transport{0};
+
+    // Each packet can only be matched by a single copy from the other transport
+    bool matched{true};
+  };
+
+  /// The packets recently received with a given device ID and packet ID. Several packets are kept so that a copy
+  /// arriving over a slower transport is matched even if newer packets have already arrived over the faster one.
+  struct RecentPackets
+  {
+    static constexpr std::size_t DEPTH = 4;
+    std::array<RecentPacket, DEPTH> packets;
+    std::size_t next{0};
+  };
+
+  /// Dispatch a packet received over a transport unless it is a copy of a packet received over the other transport.
+  auto receive_from_transport(std::uint8_t transport, PacketView packet) -> void;
+
+  /// Check whether a packet is a duplicate and record it otherwise.
+  auto is_duplicate(std::uint8_t transport, PacketView packet) -> bool;
+
+  /// The transports receive independently, so there is no connection to read from.
+  auto read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t override;
+
+  /// Write data over the transports according to the redundancy mode.
+  auto write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t override;
+
+  RedundancyMode mode_;
+  std::chrono::milliseconds duplicate_window_;
+
+  // Recent packets are keyed by (device ID << 8 | packet ID); the transports may be serviced by different reactors.
+  std::unordered_map<std::uint16_t, RecentPackets> recent_packets_;
+  std::mutex recent_packets_lock_;
+  std::atomic<std::uint64_t> duplicates_dropped_{0};
+
+  // Writes hold the lock in shared mode so that the transports are not destroyed while they are being written to.
+  // The transports are declared last so that, if the constructor throws, they are destroyed before the state that
+  // their receive callbacks use.
+  mutable std::shared_mutex transports_lock_;
+  std::unique_ptr<Client> primary_;
+  std::unique_ptr<Client> secondary_;
+};
+
+}  // namespace libreach::protocol
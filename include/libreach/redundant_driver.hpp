@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "libreach/driver.hpp"
+#include "libreach/redundant_client.hpp"
+#include "libreach/serial_client.hpp"
+
+namespace libreach
+{
+
+class RedundantDriver : public ReachDriver
+{
+public:
+  /// Create a new redundant driver that communicates over both an Ethernet (UDP) link and a serial link using:
+  ///   - an IP address for communication (e.g., "192.168.2.3"),
+  ///   - a port number for communication (e.g., 12345),
+  ///   - a serial port for communication (e.g., "/dev/ttyUSB0"),
+  ///   - the method used to send packets over the links (the Ethernet link is the primary link),
+  ///   - a queue size for storing incoming packets,
+  ///   - a number of worker threads for processing incoming packets,
+  ///   - a session timeout for heartbeat monitoring,
+  ///   - whether to request low-latency operation from the serial driver,
+  ///   - the baud rate of the serial port,
+  ///   - the method used to write outgoing packets,
+  ///   - the method used to distribute incoming packets to the workers.
+  explicit RedundantDriver(
+    const std::string & addr,
+    std::uint16_t port,
+    const std::string & serial_port,
+    protocol::RedundancyMode mode = protocol::RedundancyMode::BROADCAST,
+    std::size_t q_size = 100,
+    std::size_t n_workers = 1,
+    std::chrono::milliseconds session_timeout = std::chrono::seconds(3),
+    bool low_latency = false,
+    std::uint32_t baud_rate = protocol::DEFAULT_BAUD_RATE,
+    TransmitMode transmit_mode = TransmitMode::SYNCHRONOUS,
+    DispatchMode dispatch_mode = DispatchMode::ANY_WORKER);
+
+  ~RedundantDriver() = default;
+
+  /// Check if the Ethernet link is connected to the robot.
+  [[nodiscard]] auto ethernet_connected() const -> bool;
+
+  /// Check if the serial link is connected to the robot.
+  [[nodiscard]] auto serial_connected() const -> bool;
+
+  /// Get the number of packets that have been dropped because they were already received over the other link.
+  [[nodiscard]] auto duplicates_dropped() const -> std::uint64_t;
+
+private:
+  protocol::RedundantClient * redundant_client_;
+};
+
+}  // namespace libreach
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "libreach/capture.hpp"
+#include "libreach/client.hpp"
+
+namespace libreach::protocol
+{
+
+/// The rate at which a capture is replayed.
+enum class ReplaySpeed : std::uint8_t
+{
+  /// Bytes are replayed with the timing that they were originally received with.
+  ORIGINAL,
+
+  /// Bytes are replayed as quickly as they can be decoded.
+  MAXIMUM,
+};
+
+/// A client that replays the bytes received in a capture (see Client::start_capture) instead of using a connection.
+/// Packets sent using the client are discarded.
+class ReplayClient : public Client
+{
+public:
+  /// Create a new replay client using a
+  /// - capture file,
+  /// - packet callback,
+  /// - session timeout,
+  /// - replay speed,
+  /// - and the reactor used to service the heartbeat timer (defaults to the shared reactor).
+  ReplayClient(
+    const std::string & path,
+    std::function<void(PacketView)> && callback,
+    std::chrono::milliseconds session_timeout,
+    ReplaySpeed speed = ReplaySpeed::ORIGINAL,
+    std::shared_ptr<Reactor> reactor = nullptr);
+
+  ~ReplayClient() override;
+
+  /// Replay has no underlying connection, so this is always -1.
+  [[nodiscard]] auto native_handle() const -> int override;
+
+  /// Start replaying the capture in a separate thread.
+  auto start() -> void;
+
+  /// Check whether all of the received bytes in the capture have been replayed.
+  [[nodiscard]] auto finished() const -> bool;
+
+  /// Block until all of the received bytes in the capture have been replayed.
+  auto wait_until_finished() const -> void;
+
+private:
+  /// Feed the received bytes in the capture to the decoder.
+  auto replay() -> void;
+
+  /// Replay has no connection to read from; received bytes are only provided by the capture.
+  auto read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t override;
+
+  /// Discard the data that is written.
+  auto write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t override;
+
+  CaptureReader reader_;
+  ReplaySpeed speed_;
+
+  std::atomic<bool> finished_{false};
+  std::thread replay_thread_;
+
+  // Replay at the original speed waits between records, which must be interrupted if the client is destroyed.
+  std::atomic<bool> stopping_{false};
+  std::mutex stop_lock_;
+  std::condition_variable stop_cv_;
+};
+
+}  // namespace libreach::protocol
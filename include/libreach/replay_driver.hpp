@@ -0,0 +1,70 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "libreach/driver.hpp"
+#include "libreach/replay_client.hpp"
+
+namespace libreach
+{
+
+class ReplayDriver : public ReachDriver
+{
+public:
+  /// Create a new replay driver using:
+  ///   - a capture file recorded by a client (see ReachDriver::start_capture),
+  ///   - the speed at which to replay the capture,
+  ///   - a queue size for storing incoming packets,
+  ///   - a number of worker threads for processing incoming packets,
+  ///   - a session timeout for heartbeat monitoring,
+  ///   - the method used to distribute incoming packets to the workers.
+  ///
+  /// The capture begins replaying once the driver has been created; packets sent by the driver are discarded.
+  explicit ReplayDriver(
+    const std::string & path,
+    protocol::ReplaySpeed speed = protocol::ReplaySpeed::ORIGINAL,
+    std::size_t q_size = 100,
+    std::size_t n_workers = 1,
+    std::chrono::milliseconds session_timeout = std::chrono::seconds(3),
+    DispatchMode dispatch_mode = DispatchMode::ANY_WORKER);
+
+  ~ReplayDriver() = default;
+
+  /// Check whether all of the received bytes in the capture have been replayed.
+  [[nodiscard]] auto finished() const -> bool;
+
+  /// Block until all of the received bytes in the capture have been replayed.
+  auto wait_until_finished() const -> void;
+
+private:
+  protocol::ReplayClient * replay_client_;
+};
+
+}  // namespace libreach
@@ -26,7 +26,10 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "libreach/client.hpp"
@@ -34,6 +37,18 @@
 namespace libreach::protocol
 {
 
+/// The default baud rate of Reach Robotics devices.
+const std::uint32_t DEFAULT_BAUD_RATE = 115200;
+
+/// Get the theoretical number of packets with a given amount of data that a serial link can transfer each second. Each
+/// byte requires 10 bits on the wire (a start bit, 8 data bits, and a stop bit), and each packet is assumed to require
+/// the maximum number of bytes once encoded.
+constexpr auto frame_capacity(std::uint32_t baud_rate, std::size_t data_size) -> double
+{
+  const std::size_t bits_per_frame = 10 * max_encoded_packet_size(data_size);
+  return static_cast<double>(baud_rate) / static_cast<double>(bits_per_frame);
+}
+
 class SerialClient : public Client
 {
 public:
@@ -41,23 +56,49 @@ public:
   /// - serial port,
   /// - packet callback,
   /// - session timeout,
-  /// - and maximum number of bytes to read on each poll.
+  /// - maximum number of bytes to read on each poll,
+  /// - the reactor used to service the connection (defaults to the shared reactor),
+  /// - whether to request low-latency operation from the serial driver (e.g., FTDI USB adapters otherwise buffer
+  ///   received bytes for up to 16 ms),
+  /// - and the baud rate (non-standard rates are supported if the serial driver supports them).
   explicit SerialClient(
     const std::string & port,
-    std::function<void(const std::vector<Packet> &)> && callback,
-    std::chrono::seconds session_timeout,
-    std::uint16_t max_bytes_to_read = 32);
+    std::function<void(PacketView)> && callback,
+    std::chrono::milliseconds session_timeout,
+    std::uint16_t max_bytes_to_read = 32,
+    std::shared_ptr<Reactor> reactor = nullptr,
+    bool low_latency = false,
+    std::uint32_t baud_rate = DEFAULT_BAUD_RATE);
 
   ~SerialClient() override;
 
+  /// Get the baud rate of the serial port.
+  [[nodiscard]] auto baud_rate() const -> std::uint32_t { return baud_rate_; }
+
+  /// Get the file descriptor of the serial port.
+  [[nodiscard]] auto native_handle() const -> int override;
+
 private:
-  /// Read n bytes from the serial port into a buffer.
-  auto read_bytes(std::deque<std::uint8_t> & buffer, std::size_t n_bytes) const -> ssize_t override;
+  /// Open and configure the serial port.
+  auto open_port() -> void;
+
+  /// Close the serial port and open it again.
+  auto reopen_connection() -> bool override;
+
+  /// Set the ASYNC_LOW_LATENCY flag of the serial port. Not all serial drivers support this, so failures are reported
+  /// without closing the port.
+  auto enable_low_latency() const -> void;
+
+  /// Read up to buffer.size() bytes from the serial port into a buffer.
+  auto read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t override;
 
   /// Write data to the serial port.
-  auto write_to_connection(const std::vector<std::uint8_t> & data) const -> ssize_t override;
+  auto write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t override;
 
-  int handle_;
+  std::string port_;
+  int handle_{-1};
+  std::uint32_t baud_rate_;
+  bool low_latency_;
 };
 
 }  // namespace libreach::protocol
@@ -26,6 +26,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "libreach/driver.hpp"
@@ -41,14 +42,29 @@ public:
   ///   - a serial port for communication (e.g., "/dev/ttyUSB0"),
   ///   - a queue size for storing incoming packets,
   ///   - a number of worker threads for processing incoming packets,
-  ///   - a session timeout for heartbeat monitoring.
+  ///   - a session timeout for heartbeat monitoring,
+  ///   - whether to request low-latency operation from the serial driver,
+  ///   - the baud rate of the serial port,
+  ///   - the method used to write outgoing packets,
+  ///   - the method used to distribute incoming packets to the workers.
   explicit SerialDriver(
     const std::string & port,
     std::size_t q_size = 100,
     std::size_t n_workers = 1,
-    std::chrono::seconds session_timeout = std::chrono::seconds(3));
+    std::chrono::milliseconds session_timeout = std::chrono::seconds(3),
+    bool low_latency = false,
+    std::uint32_t baud_rate = protocol::DEFAULT_BAUD_RATE,
+    TransmitMode transmit_mode = TransmitMode::SYNCHRONOUS,
+    DispatchMode dispatch_mode = DispatchMode::ANY_WORKER);
 
   ~SerialDriver() = default;
+
+  /// Get the theoretical number of packets with the given amount of data (e.g., 4 bytes for a float) that the serial
+  /// link can transfer each second in each direction.
+  [[nodiscard]] auto frame_capacity(std::size_t data_size) const -> double;
+
+private:
+  std::uint32_t baud_rate_;
 };
 
 }  // namespace libreach
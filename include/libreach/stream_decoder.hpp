@@ -0,0 +1,104 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+#include "libreach/packet.hpp"
+
+namespace libreach::protocol
+{
+
+/// Counters that describe the health of a received byte stream.
+struct DecodeStatistics
+{
+  // Number of packets that were decoded successfully
+  std::uint64_t frames_decoded = 0;
+
+  // Number of frames that were dropped because they were corrupted or incomplete
+  std::uint64_t frames_lost = 0;
+
+  // Number of encoded bytes that belonged to dropped frames
+  std::uint64_t bytes_discarded = 0;
+};
+
+/// Incrementally decode a COBS-framed byte stream. Bytes may be provided in arbitrarily sized chunks; each byte is
+/// COBS-decoded as it arrives, and a packet is emitted as soon as the delimiter that ends its frame is received.
+class StreamDecoder
+{
+public:
+  /// Create a new stream decoder given a callback to execute for each decoded packet. The packet view provided to the
+  /// callback is only valid for the duration of the callback.
+  explicit StreamDecoder(std::function<void(PacketView)> && callback);
+
+  /// Decode a chunk of bytes from the stream.
+  auto decode(std::span<const std::uint8_t> bytes) -> void;
+
+  /// Discard the partially received frame, if any. A discarded frame is counted as lost.
+  auto reset() -> void;
+
+  /// Get the statistics collected since the decoder was created.
+  [[nodiscard]] auto statistics() const -> const DecodeStatistics & { return statistics_; }
+
+private:
+  /// Handle the end of the current frame.
+  auto complete_frame() -> void;
+
+  /// Clear the state of the current frame.
+  auto clear_frame() -> void;
+
+  /// Record that the current frame was dropped.
+  auto drop_frame() -> void;
+
+  std::function<void(PacketView)> callback_;
+
+  // The decoded frame contains the packet data, packet ID, device ID, length, and CRC
+  std::array<std::uint8_t, MAX_PACKET_DATA_SIZE + 4> frame_{};
+  std::size_t frame_size_ = 0;
+
+  // Number of encoded bytes received for the current frame, excluding its delimiter
+  std::size_t encoded_size_ = 0;
+
+  // Number of bytes remaining in the current COBS block; a value of zero indicates that a code byte is expected
+  std::size_t block_remaining_ = 0;
+
+  // Whether the current COBS block is terminated by an implicit zero
+  bool block_has_zero_ = false;
+
+  // Whether any bytes of the current frame have been received
+  bool frame_started_ = false;
+
+  // Whether the current frame is invalid and should be dropped once its delimiter is received
+  bool discarding_ = false;
+
+  DecodeStatistics statistics_;
+};
+
+}  // namespace libreach::protocol
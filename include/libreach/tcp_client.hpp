@@ -0,0 +1,96 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <netinet/in.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "libreach/client.hpp"
+
+namespace libreach::protocol
+{
+
+class TcpClient : public Client
+{
+public:
+  /// Create a new TCP client using an
+  /// - IP address,
+  /// - port,
+  /// - packet callback,
+  /// - session timeout,
+  /// - maximum number of bytes to read on each poll,
+  /// - and the reactor used to service the connection (defaults to the shared reactor).
+  ///
+  /// Packets are framed in the same way as on a serial port, so this can be used with serial-to-Ethernet bridges.
+  TcpClient(
+    const std::string & addr,
+    std::uint16_t port,
+    std::function<void(PacketView)> && callback,
+    std::chrono::milliseconds session_timeout,
+    std::uint16_t max_bytes_to_read = 1024,
+    std::shared_ptr<Reactor> reactor = nullptr);
+
+  ~TcpClient() override;
+
+  /// Get the file descriptor of the TCP socket.
+  [[nodiscard]] auto native_handle() const -> int override;
+
+private:
+  /// Read the available data from the TCP socket, stopping once the remote end closes the connection.
+  auto read_available() -> void override;
+
+  /// Read up to buffer.size() bytes from the TCP socket into a buffer.
+  auto read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t override;
+
+  /// Write all of the data to the TCP socket, retrying if only part of the data is written.
+  auto write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t override;
+
+  /// Open a socket and start connecting it to the robot without blocking. Returns false if the connection is still
+  /// being established, in which case the socket becomes writable once it is.
+  auto start_connecting() -> bool;
+
+  /// Check that the socket connected and configure it; this closes the socket and throws if the connection failed.
+  auto finish_connecting() -> void;
+
+  /// Close the socket and start connecting a new one.
+  auto reopen_connection() -> bool override;
+
+  /// Finish connecting the new socket once it is writable.
+  auto finish_reopening_connection() -> void override;
+
+  /// Request that the acknowledgements for the data that has been received are sent immediately.
+  auto enable_quick_ack() const -> void;
+
+  struct sockaddr_in address_{};
+  int socket_{-1};
+};
+
+}  // namespace libreach::protocol
@@ -28,16 +28,24 @@
 #include <netinet/in.h>
 #include <netinet/udp.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "libreach/client.hpp"
 
 namespace libreach::protocol
 {
 
+/// The largest UDP payload that fits in a standard 1500-byte Ethernet frame.
+const std::size_t MAX_DATAGRAM_SIZE = 1472;
+
 class UdpClient : public Client
 {
 public:
@@ -46,24 +54,43 @@ public:
   /// - port,
   /// - packet callback,
   /// - session timeout,
-  /// - and a maximum number of bytes to read on each poll.
+  /// - the size of each datagram buffer (at least MAX_DATAGRAM_SIZE bytes are always used),
+  /// - and the reactor used to service the connection (defaults to the shared reactor).
   UdpClient(
     const std::string & addr,
     std::uint16_t port,
-    std::function<void(const std::vector<Packet> &)> && callback,
-    std::chrono::seconds session_timeout,
-    std::uint16_t max_bytes_to_read = 64);
+    std::function<void(PacketView)> && callback,
+    std::chrono::milliseconds session_timeout,
+    std::uint16_t max_bytes_to_read = MAX_DATAGRAM_SIZE,
+    std::shared_ptr<Reactor> reactor = nullptr);
 
   ~UdpClient() override;
 
+  /// Get the file descriptor of the UDP socket.
+  [[nodiscard]] auto native_handle() const -> int override;
+
 private:
-  /// Read n bytes from the UDP socket into a buffer.
-  auto read_bytes(std::deque<std::uint8_t> & buffer, std::size_t n_bytes) const -> ssize_t override;
+  /// Receive the available datagrams in batches using recvmmsg. Each datagram is decoded independently.
+  auto read_available() -> void override;
+
+  /// Receive the pending error (and any datagrams) instead of losing the connection; the socket is connectionless, so
+  /// an error such as an ICMP port unreachable only means that the robot is not listening yet.
+  auto handle_hangup() -> void override;
+
+  /// Read up to buffer.size() bytes from the UDP socket into a buffer.
+  auto read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t override;
 
   /// Write data to the UDP socket.
-  auto write_to_connection(const std::vector<std::uint8_t> & data) const -> ssize_t override;
+  auto write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t override;
 
   int socket_;
+
+  // Datagrams are received in batches of up to N_DATAGRAMS with a single call to recvmmsg.
+  static constexpr std::size_t N_DATAGRAMS = 16;
+  std::size_t datagram_size_;
+  std::vector<std::uint8_t> datagram_buffers_;
+  std::array<struct iovec, N_DATAGRAMS> datagram_iovecs_{};
+  std::array<struct mmsghdr, N_DATAGRAMS> datagrams_{};
 };
 
 }  // namespace libreach::protocol
@@ -43,13 +43,17 @@ public:
   ///   - a port number for communication (e.g., 12345),
   ///   - a queue size for storing incoming packets,
   ///   - a number of worker threads for processing incoming packets,
-  ///   - a session timeout for heartbeat monitoring.
+  ///   - a session timeout for heartbeat monitoring,
+  ///   - the method used to write outgoing packets,
+  ///   - the method used to distribute incoming packets to the workers.
   explicit UdpDriver(
     const std::string & addr,
     std::uint16_t port,
     std::size_t q_size = 100,
     std::size_t n_workers = 1,
-    std::chrono::seconds session_timeout = std::chrono::seconds(3));
+    std::chrono::milliseconds session_timeout = std::chrono::seconds(3),
+    TransmitMode transmit_mode = TransmitMode::SYNCHRONOUS,
+    DispatchMode dispatch_mode = DispatchMode::ANY_WORKER);
 
   ~UdpDriver() = default;
 };
@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "baud_rate.hpp"
+
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+#include <stdexcept>
+
+namespace libreach::protocol
+{
+
+auto set_baud_rate(int fd, std::uint32_t baud_rate) -> void
+{
+  if (baud_rate == 0) {
+    throw std::invalid_argument("The baud rate must be greater than zero.");
+  }
+
+  struct termios2 tty;
+
+  if (ioctl(fd, TCGETS2, &tty) < 0) {
+    throw std::runtime_error("Unable to get the current terminal configurations.");
+  }
+
+  // BOTHER indicates that the rates are given in c_ispeed and c_ospeed instead of as one of the predefined constants
+  tty.c_cflag &= ~CBAUD;
+  tty.c_cflag |= BOTHER;
+  tty.c_ispeed = baud_rate;
+  tty.c_ospeed = baud_rate;
+
+  // The input rate is specified explicitly rather than being set to match the output rate
+  tty.c_cflag &= ~(CBAUD << IBSHIFT);
+  tty.c_cflag |= BOTHER << IBSHIFT;
+
+  if (ioctl(fd, TCSETS2, &tty) < 0) {
+    throw std::runtime_error("Unable to set the baud rate of the serial port.");
+  }
+}
+
+}  // namespace libreach::protocol
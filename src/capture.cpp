@@ -0,0 +1,218 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "libreach/capture.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace libreach::protocol
+{
+
+namespace
+{
+
+/// Identifies a capture file and the version of its format.
+const std::array<std::uint8_t, 8> CAPTURE_MAGIC = {'R', 'E', 'A', 'C', 'H', 'C', 'A', 'P'};
+const std::uint32_t CAPTURE_VERSION = 1;
+
+struct CaptureHeader
+{
+  std::array<std::uint8_t, 8> magic;
+  std::uint32_t version;
+  std::uint32_t reserved;
+};
+
+/// Precedes the data of each record. Records are aligned to 8 bytes so that their headers can be read in place.
+struct RecordHeader
+{
+  // A zero timestamp marks the end of the records, since the file is extended with zeros before it is written
+  std::uint64_t timestamp_ns;
+  std::uint32_t size;
+  std::uint8_t direction;
+  std::uint8_t datagram;
+  std::uint16_t reserved;
+};
+
+const std::size_t RECORD_ALIGNMENT = 8;
+
+/// The file is grown in increments of this size so that it does not need to be remapped for every record.
+const std::size_t CAPTURE_GROWTH = 16 * 1024 * 1024;
+
+constexpr auto align_record(std::size_t size) -> std::size_t
+{
+  return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+}  // namespace
+
+CaptureWriter::CaptureWriter(const std::string & path)
+: handle_(open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+{
+  if (handle_ < 0) {
+    throw std::runtime_error("Failed to create capture file " + path);
+  }
+
+  if (!reserve(CAPTURE_GROWTH)) {
+    close(handle_);
+    throw std::runtime_error("Failed to allocate capture file " + path);
+  }
+
+  const CaptureHeader header = {CAPTURE_MAGIC, CAPTURE_VERSION, 0};
+  std::memcpy(data_, &header, sizeof(header));
+  size_ = sizeof(header);
+}
+
+CaptureWriter::~CaptureWriter()
+{
+  munmap(data_, capacity_);
+
+  // Remove the unused space that was reserved at the end of the file; if this fails, the space remains zeroed, which
+  // readers treat as the end of the records
+  if (ftruncate(handle_, static_cast<off_t>(size_)) < 0) {
+    std::cout << "Failed to remove the unused space from the capture file\n";
+  }
+  close(handle_);
+}
+
+auto CaptureWriter::record(CaptureDirection direction, std::span<const std::uint8_t> data, bool datagram) -> bool
+{
+  const std::size_t record_size = align_record(sizeof(RecordHeader) + data.size());
+
+  if (size_ + record_size > capacity_ && !reserve(std::max(size_ + record_size, capacity_ + CAPTURE_GROWTH))) {
+    return false;
+  }
+
+  const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch());
+
+  const RecordHeader header = {
+    static_cast<std::uint64_t>(timestamp.count()),
+    static_cast<std::uint32_t>(data.size()),
+    static_cast<std::uint8_t>(direction),
+    static_cast<std::uint8_t>(datagram ? 1 : 0),
+    0};
+
+  std::memcpy(data_ + size_ + sizeof(header), data.data(), data.size());
+  std::memcpy(data_ + size_, &header, sizeof(header));
+  size_ += record_size;
+
+  return true;
+}
+
+auto CaptureWriter::reserve(std::size_t capacity) -> bool
+{
+  if (ftruncate(handle_, static_cast<off_t>(capacity)) < 0) {
+    return false;
+  }
+
+  void * data = data_ == nullptr ? mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, handle_, 0)
+                                 : mremap(data_, capacity_, capacity, MREMAP_MAYMOVE);
+
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  data_ = static_cast<std::uint8_t *>(data);
+  capacity_ = capacity;
+
+  return true;
+}
+
+CaptureReader::CaptureReader(const std::string & path)
+{
+  const int handle = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (handle < 0) {
+    throw std::runtime_error("Failed to open capture file " + path);
+  }
+
+  struct stat file_stat;
+  if (fstat(handle, &file_stat) < 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(CaptureHeader)) {
+    close(handle);
+    throw std::runtime_error("Invalid capture file " + path);
+  }
+
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  void * data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, handle, 0);
+  close(handle);
+
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Failed to map capture file " + path);
+  }
+
+  data_ = static_cast<const std::uint8_t *>(data);
+
+  // Records are read in order, so the kernel can read ahead aggressively
+  madvise(data, size_, MADV_SEQUENTIAL);
+
+  CaptureHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+
+  if (header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION) {
+    munmap(data, size_);
+    throw std::runtime_error("Unsupported capture file " + path);
+  }
+
+  rewind();
+}
+
+CaptureReader::~CaptureReader() { munmap(const_cast<std::uint8_t *>(data_), size_); }
+
+auto CaptureReader::next() -> std::optional<CaptureRecord>
+{
+  if (offset_ >= size_ || size_ - offset_ < sizeof(RecordHeader)) {
+    return std::nullopt;
+  }
+
+  RecordHeader header;
+  std::memcpy(&header, data_ + offset_, sizeof(header));
+
+  // Records that were being written when the capture ended are incomplete
+  if (header.timestamp_ns == 0 || header.size > size_ - offset_ - sizeof(header)) {
+    return std::nullopt;
+  }
+
+  const CaptureRecord record = {
+    std::chrono::nanoseconds(header.timestamp_ns),
+    static_cast<CaptureDirection>(header.direction),
+    header.datagram != 0,
+    std::span(data_ + offset_ + sizeof(header), header.size)};
+
+  offset_ += align_record(sizeof(header) + header.size);
+
+  return record;
+}
+
+auto CaptureReader::rewind() -> void { offset_ = sizeof(CaptureHeader); }
+
+}  // namespace libreach::protocol
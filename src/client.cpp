@@ -25,64 +25,357 @@
 
 #include "libreach/client.hpp"
 
+#include <poll.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <iostream>
-#include <ranges>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 #include "libreach/packet_id.hpp"
 
+#ifdef LIBREACH_USE_IO_URING
+#include "io_uring.hpp"
+#endif
+
 namespace libreach::protocol
 {
 
-Client::Client(std::function<void(const std::vector<Packet> &)> && callback, std::chrono::seconds session_timeout)
-: packet_callback_(std::forward<std::function<void(const std::vector<Packet> &)>>(callback))
+namespace
+{
+
+/// The delay before the first attempt to reconnect; the delay doubles after each failed attempt up to the maximum.
+const std::chrono::milliseconds INITIAL_RECONNECT_DELAY(10);
+const std::chrono::milliseconds MAX_RECONNECT_DELAY(1000);
+
+/// Get the heartbeat frequency (Hz) at which three heartbeats are expected within the session timeout. The protocol
+/// supports frequencies from 1 Hz to 255 Hz.
+auto default_heartbeat_frequency(std::chrono::milliseconds session_timeout) -> std::uint8_t
 {
+  const std::int64_t frequency = (3000 + session_timeout.count() - 1) / session_timeout.count();
+  return static_cast<std::uint8_t>(std::clamp<std::int64_t>(frequency, 1, 255));
+}
+
+}  // namespace
+
+Client::Client(
+  std::function<void(PacketView)> && callback,
+  std::chrono::milliseconds session_timeout,
+  std::shared_ptr<Reactor> reactor)
+: packet_callback_(std::forward<std::function<void(PacketView)>>(callback)),
+  reactor_(reactor ? std::move(reactor) : Reactor::shared()),
+  session_timeout_(session_timeout),
+  heartbeat_frequency_(session_timeout.count() > 0 ? default_heartbeat_frequency(session_timeout) : 1),
+  decoder_([this](PacketView packet) { receive_packet(packet); })
+{
+  if (session_timeout.count() <= 0) {
+    throw std::invalid_argument("The session timeout must be positive.");
+  }
+
+  packet_callback_set_.store(static_cast<bool>(packet_callback_));
   running_.store(true);
 
-  set_last_heartbeat(std::chrono::steady_clock::now());
-  heartbeat_monitor_thread_ = std::thread([this, session_timeout] {
-    while (running_.load()) {
-      check_heartbeat(session_timeout);
-      std::this_thread::sleep_for(session_timeout / 2);
-    }
-  });
+  // The client is considered connected until the first session timeout passes without a heartbeat
+  last_heartbeat_ = std::chrono::steady_clock::now();
+  connection_state_.store(ConnectionState::CONNECTED);
+  notify_connection_state(ConnectionState::CONNECTED);
+
+  heartbeat_timer_ = reactor_->add_deadline([this] { check_heartbeat(); });
+  reactor_->set_deadline(heartbeat_timer_, session_timeout_);
+
+  reconnect_delay_ = INITIAL_RECONNECT_DELAY;
+  reconnect_timer_ = reactor_->add_deadline([this] { reconnect(); });
 }
 
+Client::~Client() { shutdown_client(); }
+
 auto Client::start_polling_connection(std::uint16_t max_bytes_to_read) -> void
 {
-  polling_thread_ = std::thread(&Client::poll_connection, this, max_bytes_to_read);
+  max_bytes_to_read_ = max_bytes_to_read;
+
+  // Packets are dispatched from the reactor thread as soon as the delimiter that ends their frame is read
+#ifdef LIBREACH_USE_IO_URING
+  {
+    // Writes use the ring while holding the connection lock in shared mode
+    const std::unique_lock<std::shared_mutex> lock(connection_lock_);
+    io_uring_ = IoUring::create(native_handle(), max_bytes_to_read);
+  }
+
+  if (io_uring_) {
+    polling_handle_.store(io_uring_->ring_fd());
+    reactor_->add_reader(io_uring_->ring_fd(), [this](bool /*hangup*/) { poll_io_uring(); });
+  }
+#endif
+
+  if (!io_uring_) {
+    read_buffer_.resize(max_bytes_to_read);
+    polling_handle_.store(native_handle());
+    reactor_->add_reader(native_handle(), [this](bool hangup) { poll_connection(hangup); });
+  }
 
   disable_heartbeat();
-  enable_heartbeat(1);  // Set the heartbeat rate to its minimum value (1 Hz)
+  enable_heartbeat(heartbeat_frequency_.load());
+}
+
+auto Client::stop_polling_connection() -> void
+{
+  if (const int handle = polling_handle_.exchange(-1); handle >= 0) {
+    reactor_->remove_reader(handle);
+  }
+}
+
+auto Client::lose_connection() -> void
+{
+  stop_polling_connection();
+  connection_lost_ = true;
+
+  bool disconnected = false;
+  {
+    const std::lock_guard<std::mutex> lock(last_heartbeat_lock_);
+    if (connection_state_.load() == ConnectionState::CONNECTED) {
+      connection_state_.store(ConnectionState::DISCONNECTED);
+      disconnected = true;
+    }
+  }
+
+  if (disconnected) {
+    notify_connection_state(ConnectionState::DISCONNECTED);
+  }
+
+  reconnect_delay_ = INITIAL_RECONNECT_DELAY;
+  reactor_->set_deadline(reconnect_timer_, reconnect_delay_);
+}
+
+auto Client::reconnect() -> void
+{
+  if (!running_.load()) {
+    return;
+  }
+
+  if (!connection_lost_ && connection_state_.load() == ConnectionState::CONNECTED) {
+    reconnect_delay_ = INITIAL_RECONNECT_DELAY;
+    return;
+  }
+
+  // A connection that is still being opened is given until the next attempt to open
+  if (const int handle = reopening_handle_.exchange(-1); handle >= 0) {
+    reactor_->remove_writer(handle);
+    std::cout << "Timed out while reopening the connection to the robot\n";
+  }
+
+  try {
+    if (connection_lost_) {
+      bool reopened = false;
+      {
+        const std::unique_lock<std::shared_mutex> lock(connection_lock_);
+
+        // The ring refers to the connection that is being replaced
+        io_uring_.reset();
+        reopened = reopen_connection();
+      }
+
+      if (reopened) {
+        restore_connection();
+      } else {
+        // Wait for the connection to open without blocking the reactor thread
+        reactor_->add_writer(native_handle(), [this](bool /*hangup*/) { finish_reopening(); });
+        reopening_handle_.store(native_handle());
+      }
+    } else if (connection_writable()) {
+      // The robot may not be reading from the connection, so the heartbeat configuration is only sent if it can be
+      // written without waiting for the robot
+      enable_heartbeat(heartbeat_frequency_.load());
+    }
+  }
+  catch (const std::exception & e) {
+    std::cout << "Failed to reconnect to the robot: " << e.what() << "\n";
+  }
+
+  // Keep trying until a heartbeat is received
+  reactor_->set_deadline(reconnect_timer_, reconnect_delay_);
+  reconnect_delay_ = std::min(reconnect_delay_ * 2, MAX_RECONNECT_DELAY);
+}
+
+auto Client::reopen_connection() -> bool { throw std::runtime_error("The connection cannot be reopened."); }
+
+auto Client::finish_reopening_connection() -> void {}
+
+auto Client::finish_reopening() -> void
+{
+  const int handle = reopening_handle_.load();
+  if (handle < 0) {
+    return;
+  }
+
+  // The writer must be removed before the connection can be polled for reads
+  reactor_->remove_writer(handle);
+
+  try {
+    {
+      const std::unique_lock<std::shared_mutex> lock(connection_lock_);
+      finish_reopening_connection();
+    }
+
+    restore_connection();
+  }
+  catch (const std::exception & e) {
+    std::cout << "Failed to reconnect to the robot: " << e.what() << "\n";
+  }
+
+  // This is cleared last so that shutdown_client waits for the connection to be polled (or not) before stopping it
+  reopening_handle_.store(-1);
+}
+
+auto Client::restore_connection() -> void
+{
+  connection_lost_ = false;
+  decoder_.reset();
+
+  // This also sends the heartbeat configuration
+  start_polling_connection(max_bytes_to_read_);
+  std::cout << "Reopened the connection to the robot\n";
+}
+
+auto Client::connection_writable() const -> bool
+{
+  struct pollfd fd = {native_handle(), POLLOUT, 0};
+  return poll(&fd, 1, 0) > 0 && (fd.revents & POLLOUT) != 0;
 }
 
 auto Client::shutdown_client() -> void
 {
   running_.store(false);
 
-  if (polling_thread_.joinable()) {
-    polling_thread_.join();
+  // The reconnect timer is removed first because reconnecting starts polling the connection again
+  if (reconnect_timer_ >= 0) {
+    reactor_->remove_timer(reconnect_timer_);
+    reconnect_timer_ = -1;
   }
 
-  if (heartbeat_monitor_thread_.joinable()) {
-    heartbeat_monitor_thread_.join();
+  // A connection that finishes reopening starts being polled, so this must also be stopped first
+  if (const int handle = reopening_handle_.exchange(-1); handle >= 0) {
+    reactor_->remove_writer(handle);
   }
+
+  // Once the connection and timers are removed from the reactor, none of the client's callbacks can be running
+  stop_polling_connection();
+
+  if (heartbeat_timer_ >= 0) {
+    reactor_->remove_timer(heartbeat_timer_);
+    heartbeat_timer_ = -1;
+  }
+
+  // In-flight requests are cancelled when the ring is destroyed, so this must happen before the connection is closed.
+  // Writes use the ring while holding the connection lock in shared mode.
+  const std::unique_lock<std::shared_mutex> lock(connection_lock_);
+  io_uring_.reset();
 }
 
 auto Client::connected() const -> bool
 {
-  const std::lock_guard<std::mutex> lock(connection_state_lock_);
-  return running_.load() && connection_state_ == ConnectionState::CONNECTED;
+  return running_.load() && connection_state_.load() == ConnectionState::CONNECTED;
+}
+
+auto Client::set_packet_callback(std::function<void(PacketView)> && callback) -> void
+{
+  if (packet_callback_set_.load()) {
+    throw std::runtime_error("The packet callback of the client has already been set.");
+  }
+
+  packet_callback_ = std::move(callback);
+  packet_callback_set_.store(true, std::memory_order_release);
+}
+
+auto Client::set_packet_batch_callback(std::function<void(std::span<const Packet>)> && callback) -> void
+{
+  if (packet_callback_set_.load()) {
+    throw std::runtime_error("The packet callback of the client has already been set.");
+  }
+
+  packet_batch_callback_ = std::move(callback);
+  packet_callback_set_.store(true, std::memory_order_release);
+}
+
+auto Client::has_packet_callback() const -> bool { return packet_callback_set_.load(); }
+
+auto Client::register_connection_callback(std::function<void(bool)> && callback) -> void
+{
+  const std::lock_guard<std::mutex> lock(connection_callback_lock_);
+  connection_callback_ = std::move(callback);
+}
+
+auto Client::set_heartbeat_frequency(std::uint8_t frequency) -> void
+{
+  if (frequency == 0) {
+    throw std::invalid_argument("The heartbeat frequency must be at least 1 Hz.");
+  }
+
+  heartbeat_frequency_.store(frequency);
+
+  // The frequency is sent when the connection is first polled, so it only needs to be updated after that
+  if (polling_handle_.load() >= 0) {
+    set_heartbeat_rate(frequency);
+  }
+}
+
+auto Client::heartbeat_frequency() const -> std::uint8_t { return heartbeat_frequency_.load(); }
+
+auto Client::decode_statistics() const -> DecodeStatistics
+{
+  const std::lock_guard<std::mutex> lock(decode_statistics_lock_);
+  return decode_statistics_;
 }
 
 auto Client::send_packet(const Packet & packet) const -> void
 {
-  if (write_to_connection(encode_packet(packet)) < 0) {
+  std::array<std::uint8_t, MAX_ENCODED_PACKET_SIZE> frame;
+  const std::size_t frame_size = encode_packet_into(packet, frame);
+
+  if (write_bytes(std::span(frame).first(frame_size)) < 0) {
     throw std::runtime_error("Failed to send packet; the connection was likely lost.");
   }
 }
 
+auto Client::send_packets(std::span<const Packet> packets) const -> void
+{
+  send_packets(packets.size(), [packets](std::size_t i) -> const Packet & { return packets[i]; });
+}
+
+auto Client::start_capture(const std::string & path) -> void
+{
+  auto capture = std::make_unique<CaptureWriter>(path);
+
+  const std::lock_guard<std::mutex> lock(capture_lock_);
+  capture_ = std::move(capture);
+  capturing_.store(true);
+}
+
+auto Client::stop_capture() -> void
+{
+  const std::lock_guard<std::mutex> lock(capture_lock_);
+  capturing_.store(false);
+  capture_.reset();
+}
+
+auto Client::capture_bytes(CaptureDirection direction, std::span<const std::uint8_t> bytes, bool datagram) const
+  -> void
+{
+  if (!capturing_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(capture_lock_);
+
+  if (capture_ && !capture_->record(direction, bytes, datagram)) {
+    std::cout << "Failed to grow the capture file; the capture has been stopped.\n";
+    capturing_.store(false);
+    capture_.reset();
+  }
+}
+
 auto Client::enable_heartbeat(std::uint8_t frequency) const -> void
 {
   // Request the model number as the heartbeat because there isn't an official heartbeat message
@@ -97,66 +390,174 @@ auto Client::set_heartbeat_rate(std::uint8_t frequency) const -> void
   send_packet(Packet(PacketId::HEARTBEAT_FREQUENCY, 0xFF, {frequency}));
 }
 
-auto Client::set_last_heartbeat(std::chrono::time_point<std::chrono::steady_clock> t) -> void
+auto Client::receive_heartbeat() -> void
 {
-  const std::lock_guard<std::mutex> lock(last_heartbeat_lock_);
-  last_heartbeat_ = t;
+  bool reconnected = false;
+
+  {
+    const std::lock_guard<std::mutex> lock(last_heartbeat_lock_);
+    last_heartbeat_ = std::chrono::steady_clock::now();
+    reactor_->set_deadline(heartbeat_timer_, session_timeout_);
+
+    // The connection is restored as soon as a heartbeat arrives rather than at the next check
+    if (connection_state_.load() == ConnectionState::DISCONNECTED) {
+      connection_state_.store(ConnectionState::CONNECTED);
+      reconnected = true;
+    }
+  }
+
+  if (reconnected) {
+    notify_connection_state(ConnectionState::CONNECTED);
+  }
 }
 
-auto Client::check_heartbeat(std::chrono::seconds timeout) -> void
+auto Client::check_heartbeat() -> void
 {
-  const std::scoped_lock lock(last_heartbeat_lock_, connection_state_lock_);
+  {
+    const std::lock_guard<std::mutex> lock(last_heartbeat_lock_);
+
+    // A heartbeat may have been received after the deadline expired but before this was executed
+    const auto elapsed = std::chrono::steady_clock::now() - last_heartbeat_;
+    if (elapsed < session_timeout_) {
+      reactor_->set_deadline(heartbeat_timer_, session_timeout_ - elapsed);
+      return;
+    }
+
+    if (connection_state_.load() == ConnectionState::DISCONNECTED) {
+      return;
+    }
+    connection_state_.store(ConnectionState::DISCONNECTED);
+  }
 
-  const bool timeout_occurred = std::chrono::steady_clock::now() - last_heartbeat_ > timeout;
+  std::stringstream ss;
+  ss << "Client timeout occurred; heartbeat has not been received in the last " << session_timeout_.count() << " ms\n";
+  std::cout << ss.str();
 
-  if (timeout_occurred && connection_state_ == ConnectionState::CONNECTED) {
-    std::stringstream ss;
-    ss << "Client timeout occurred; heartbeat has not been received in the last " << timeout.count() << " seconds\n";
-    std::cout << ss.str();
-  } else if (!timeout_occurred && connection_state_ == ConnectionState::DISCONNECTED) {
+  notify_connection_state(ConnectionState::DISCONNECTED);
+
+  reconnect_delay_ = INITIAL_RECONNECT_DELAY;
+  reactor_->set_deadline(reconnect_timer_, reconnect_delay_);
+}
+
+auto Client::notify_connection_state(ConnectionState connection_state) -> void
+{
+  if (connection_state == ConnectionState::CONNECTED) {
     std::cout << "Client connection established\n";
   }
 
-  connection_state_ = timeout_occurred ? ConnectionState::DISCONNECTED : ConnectionState::CONNECTED;
+  const std::lock_guard<std::mutex> lock(connection_callback_lock_);
+  if (connection_callback_) {
+    connection_callback_(connection_state == ConnectionState::CONNECTED);
+  }
+}
+
+auto Client::poll_connection(bool hangup) -> void
+{
+  if (hangup) {
+    handle_hangup();
+    return;
+  }
+
+  read_available();
+}
+
+auto Client::handle_hangup() -> void
+{
+  std::cout << "The robot hung up; the connection was likely lost.\n";
+  lose_connection();
 }
 
-auto Client::poll_connection(std::uint16_t max_bytes_to_read) -> void
+auto Client::read_available() -> void
 {
-  std::deque<std::uint8_t> buffer(max_bytes_to_read);
-  std::size_t n_bytes_to_read = max_bytes_to_read;
+  const ssize_t bytes_read = read_bytes(read_buffer_);
 
-  while (running_.load()) {
-    if (read_bytes(buffer, n_bytes_to_read) < 0) {
+  if (bytes_read < 0) {
+    // The connection stays readable after a hard error (e.g., EIO once a USB serial adapter is unplugged), so it must
+    // stop being polled
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
       std::cout << "Failed to read from the robot; the connection was likely lost.\n";
+      lose_connection();
     }
+    return;
+  }
 
-    auto last_delim = std::ranges::find(buffer | std::views::reverse, PACKET_DELIMITER);
+  receive_bytes(std::span(read_buffer_).first(static_cast<std::size_t>(bytes_read)));
+}
 
-    if (last_delim != buffer.rend()) {
-      try {
-        const std::vector<Packet> packets = decode_packets({buffer.begin(), last_delim.base()});
+#ifdef LIBREACH_USE_IO_URING
+auto Client::poll_io_uring() -> void
+{
+  const bool reading = io_uring_->process_completions([this](std::span<const std::uint8_t> bytes) {
+    receive_bytes(bytes, io_uring_->reads_datagrams());
+  });
 
-        if (!packets.empty()) {
-          auto it = std::ranges::find_if(
-            packets, [](const Packet & packet) { return packet.packet_id() == PacketId::MODEL_NUMBER; });
+  if (!reading && polling_handle_.load() >= 0) {
+    std::cout << "The robot hung up; the connection was likely lost.\n";
+    lose_connection();
+  }
+}
+#endif
 
-          if (it != packets.end()) {
-            set_last_heartbeat(std::chrono::steady_clock::now());
-          }
+auto Client::receive_bytes(std::span<const std::uint8_t> bytes, bool datagram) -> void
+{
+  capture_bytes(CaptureDirection::RECEIVED, bytes, datagram);
 
-          packet_callback_(packets);
-        }
+  decoding_ = true;
+  decoder_.decode(bytes);
+  decoding_ = false;
 
-        buffer.erase(buffer.begin(), last_delim.base());
-      }
-      catch (const std::exception & e) {
-        std::cout << "An error occurred while attempting to decode a packet: " << e.what() << "\n";
-        buffer.clear();
-      }
-    }
+  if (datagram) {
+    decoder_.reset();
+  }
+
+  if (!received_packets_.empty()) {
+    packet_batch_callback_(received_packets_);
+    received_packets_.clear();
+  }
+
+  const std::lock_guard<std::mutex> lock(decode_statistics_lock_);
+  decode_statistics_ = decoder_.statistics();
+}
+
+auto Client::receive_packet(PacketView packet) -> void
+{
+  if (packet.packet_id() == PacketId::MODEL_NUMBER) {
+    receive_heartbeat();
+  }
+
+  if (!packet_callback_set_.load(std::memory_order_acquire)) {
+    return;
+  }
 
-    n_bytes_to_read = max_bytes_to_read - buffer.size();
+  if (!packet_batch_callback_) {
+    packet_callback_(packet);
+  } else if (decoding_) {
+    received_packets_.emplace_back(packet);
+  } else {
+    // Packets that are not decoded from a read (e.g., those forwarded by a redundant client) are dispatched alone
+    const Packet value(packet);
+    packet_batch_callback_(std::span(&value, 1));
   }
 }
 
+auto Client::forward_bytes(const Client & client, std::span<const std::uint8_t> data) -> ssize_t
+{
+  return client.write_bytes(data);
+}
+
+auto Client::write_bytes(std::span<const std::uint8_t> data) const -> ssize_t
+{
+  capture_bytes(CaptureDirection::TRANSMITTED, data, false);
+
+  const std::shared_lock<std::shared_mutex> lock(connection_lock_);
+
+#ifdef LIBREACH_USE_IO_URING
+  if (io_uring_) {
+    return io_uring_->write(data);
+  }
+#endif
+
+  return write_to_connection(data);
+}
+
 }  // namespace libreach::protocol
@@ -24,78 +24,113 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "cobs.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 
+#include "simd.hpp"
+
 namespace libreach::protocol
 {
 
 auto encode_cobs(const std::vector<std::uint8_t> & data) -> std::vector<std::uint8_t>
 {
-  std::vector<std::uint8_t> encoded_data = {0x00};
-
-  int block_start = 0;
-  int current_block_size = 0;
+  std::vector<std::uint8_t> encoded_data(max_cobs_encoded_size(data.size()));
+  encoded_data.resize(encode_cobs(data, encoded_data));
+  return encoded_data;
+}
 
-  for (const std::uint8_t it : data) {
-    if (it == 0x00) {
-      encoded_data[block_start] = static_cast<std::uint8_t>(current_block_size + 1);
+auto encode_cobs(std::span<const std::uint8_t> data, std::span<std::uint8_t> out) -> std::size_t
+{
+  if (out.size() < max_cobs_encoded_size(data.size())) {
+    throw std::invalid_argument("The output buffer is too small to store the encoded data.");
+  }
 
-      encoded_data.push_back(0x00);
+  std::size_t encoded_data_pos = 0;
+  std::size_t data_pos = 0;
 
-      block_start = encoded_data.size() - 1;
-      current_block_size = 0;
-    } else {
-      encoded_data.push_back(it);
-      current_block_size++;
+  while (true) {
+    // Each block contains at most 254 non-zero bytes; find the zero (if any) that terminates the block
+    const std::span<const std::uint8_t> block =
+      data.subspan(data_pos, std::min<std::size_t>(data.size() - data_pos, 254));
+    const std::size_t block_size = find_zero(block);
 
-      if (current_block_size >= 254) {
-        encoded_data[block_start] = static_cast<std::uint8_t>(current_block_size + 1);
+    out[encoded_data_pos] = static_cast<std::uint8_t>(block_size + 1);
+    std::memcpy(out.data() + encoded_data_pos + 1, block.data(), block_size);
 
-        encoded_data.push_back(0x00);
+    encoded_data_pos += block_size + 1;
+    data_pos += block_size;
 
-        block_start = encoded_data.size() - 1;
-        current_block_size = 0;
-      }
+    if (block_size < block.size()) {
+      data_pos++;  // Skip the zero that terminated the block
+    } else if (block_size < 254) {
+      break;
     }
   }
 
-  encoded_data[block_start] = static_cast<std::uint8_t>(current_block_size + 1);
-  encoded_data.push_back(0x00);
+  out[encoded_data_pos++] = 0x00;
 
-  return encoded_data;
+  return encoded_data_pos;
 }
 
 auto decode_cobs(const std::vector<std::uint8_t> & data) -> std::vector<std::uint8_t>
 {
-  std::vector<std::uint8_t> decoded_data;
-  std::vector<std::uint8_t>::size_type encoded_data_pos = 0;
+  std::vector<std::uint8_t> decoded_data(data.size());
+  decoded_data.resize(decode_cobs(data, decoded_data));
+  return decoded_data;
+}
+
+auto decode_cobs(std::span<const std::uint8_t> data, std::span<std::uint8_t> out) -> std::size_t
+{
+  if (out.size() < data.size()) {
+    throw std::invalid_argument("The output buffer is too small to store the decoded data.");
+  }
+
+  const std::optional<std::size_t> decoded_size = try_decode_cobs(data, out);
+
+  if (!decoded_size) {
+    throw std::runtime_error("Failed to decode the encoded data.");
+  }
+
+  return *decoded_size;
+}
 
-  while (encoded_data_pos < data.size()) {
+auto try_decode_cobs(std::span<const std::uint8_t> data, std::span<std::uint8_t> out) -> std::optional<std::size_t>
+{
+  std::size_t encoded_data_pos = 0;
+  std::size_t decoded_data_pos = 0;
+
+  while (encoded_data_pos < data.size() && data[encoded_data_pos] != 0x00) {
     const std::size_t block_size = data[encoded_data_pos] - 1;
     encoded_data_pos++;
 
-    for (std::size_t i = 0; i < block_size; ++i) {
-      const std::uint8_t byte = data[encoded_data_pos];
+    if (encoded_data_pos + block_size > data.size()) {
+      return std::nullopt;
+    }
 
-      if (byte == 0x00) {
-        throw std::runtime_error("Failed to decode the encoded data.");
-      }
+    const std::span<const std::uint8_t> block = data.subspan(encoded_data_pos, block_size);
 
-      decoded_data.push_back(data[encoded_data_pos]);
-      encoded_data_pos++;
+    if (find_zero(block) != block_size) {
+      return std::nullopt;
     }
 
-    if (data[encoded_data_pos] == 0x00) {
+    // Bytes are only ever moved towards the front of the buffer, so this is safe to perform in place
+    std::memmove(out.data() + decoded_data_pos, block.data(), block_size);
+
+    decoded_data_pos += block_size;
+    encoded_data_pos += block_size;
+
+    if (encoded_data_pos >= data.size() || data[encoded_data_pos] == 0x00) {
       break;
     }
 
     if (block_size < 0xFE) {
-      decoded_data.push_back(0x00);
+      out[decoded_data_pos++] = 0x00;
     }
   }
 
-  return decoded_data;
+  return decoded_data_pos;
 }
 
 }  // namespace libreach::protocol
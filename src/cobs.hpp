@@ -25,20 +25,85 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <span>
 #include <vector>
 
 namespace libreach::protocol
 {
 
+/// Get the maximum number of bytes needed to COBS-encode a buffer of the given size, including the trailing delimiter.
+constexpr auto max_cobs_encoded_size(std::size_t size) -> std::size_t { return size + (size / 254) + 2; }
+
+/// Incrementally encode bytes with the COBS algorithm into a caller-provided buffer. The buffer must be able to store
+/// at least max_cobs_encoded_size(n) bytes, where n is the number of bytes that will be pushed to the encoder.
+class CobsEncoder
+{
+public:
+  explicit CobsEncoder(std::span<std::uint8_t> out)
+  : out_(out)
+  {
+  }
+
+  /// Encode a single byte.
+  auto push(std::uint8_t byte) -> void
+  {
+    if (byte == 0x00) {
+      close_block();
+      return;
+    }
+
+    out_[pos_++] = byte;
+
+    if (++code_ == 0xFF) {
+      close_block();
+    }
+  }
+
+  /// Close the final block, append the delimiter, and return the total number of encoded bytes.
+  auto finish() -> std::size_t
+  {
+    out_[code_pos_] = code_;
+    out_[pos_++] = 0x00;
+    return pos_;
+  }
+
+private:
+  auto close_block() -> void
+  {
+    out_[code_pos_] = code_;
+    code_pos_ = pos_++;
+    code_ = 1;
+  }
+
+  std::span<std::uint8_t> out_;
+  std::size_t code_pos_ = 0;
+  std::size_t pos_ = 1;
+  std::uint8_t code_ = 1;
+};
+
 /// Encode serial data using the COBS algorithm.
 /// Inspired by the following source:
 ///   https://github.com/gbmhunter/SerialFiller/blob/d678acbf6d29de7042d48c6be8ecef556bb6d857/src/CobsTranscoder.cpp#L19
 auto encode_cobs(const std::vector<std::uint8_t> & data) -> std::vector<std::uint8_t>;
 
+/// Encode data with the COBS algorithm into an output buffer and return the number of encoded bytes, including the
+/// trailing delimiter. The output buffer must be able to store at least max_cobs_encoded_size(data.size()) bytes.
+auto encode_cobs(std::span<const std::uint8_t> data, std::span<std::uint8_t> out) -> std::size_t;
+
 /// Decode serial data that has been encoded with the COBS algorithm.
 /// Inspired by the following source:
 ///   https://github.com/gbmhunter/SerialFiller/blob/d678acbf6d29de7042d48c6be8ecef556bb6d857/src/CobsTranscoder.cpp#L74
 auto decode_cobs(const std::vector<std::uint8_t> & data) -> std::vector<std::uint8_t>;
 
+/// Decode COBS-encoded data into an output buffer and return the number of decoded bytes. The decoded data is never
+/// longer than the encoded data, so the output buffer may alias the input buffer to decode in place.
+auto decode_cobs(std::span<const std::uint8_t> data, std::span<std::uint8_t> out) -> std::size_t;
+
+/// Decode COBS-encoded data into an output buffer without throwing on malformed input. The number of decoded bytes is
+/// returned, or std::nullopt if the data is not valid COBS. The output buffer must be at least as large as the input.
+auto try_decode_cobs(std::span<const std::uint8_t> data, std::span<std::uint8_t> out) -> std::optional<std::size_t>;
+
 }  // namespace libreach::protocol
@@ -26,13 +26,223 @@
 #pragma once
 
 #include <array>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
-#include <vector>
+#include <span>
 
 namespace libreach::protocol
 {
 
+namespace crc_detail
+{
+
+/// Reflect the lowest `width` bits of a value about their center.
+template <std::unsigned_integral T>
+constexpr auto reflect(T value, std::size_t width) -> T
+{
+  T reflection = 0;
+
+  for (std::size_t bit = 0; bit < width; ++bit) {
+    if ((value >> bit) & 0x01) {
+      reflection |= static_cast<T>(T{1} << (width - 1 - bit));
+    }
+  }
+
+  return reflection;
+}
+
+/// Shift a CRC state left by one byte; the shifted-out bits of an 8-bit state are discarded entirely.
+template <std::unsigned_integral T>
+constexpr auto shift_left(T value) -> T
+{
+  if constexpr (sizeof(T) > 1) {
+    return static_cast<T>(value << 8);
+  } else {
+    return 0;
+  }
+}
+
+/// Shift a CRC state right by one byte.
+template <std::unsigned_integral T>
+constexpr auto shift_right(T value) -> T
+{
+  if constexpr (sizeof(T) > 1) {
+    return static_cast<T>(value >> 8);
+  } else {
+    return 0;
+  }
+}
+
+/// Generate the CRC lookup tables. Table k advances the CRC state by k + 1 bytes for a single input byte, which is what
+/// the slicing algorithm uses to process multiple bytes at once.
+template <std::unsigned_integral T, std::size_t N>
+constexpr auto make_tables(T polynomial, bool reflected) -> std::array<std::array<T, 256>, N>
+{
+  constexpr std::size_t width = 8 * sizeof(T);
+  constexpr T top_bit = T{1} << (width - 1);
+
+  const T reflected_polynomial = reflect(polynomial, width);
+
+  std::array<std::array<T, 256>, N> tables{};
+
+  for (std::size_t i = 0; i < 256; ++i) {
+    if (reflected) {
+      auto value = static_cast<T>(i);
+      for (std::size_t bit = 0; bit < 8; ++bit) {
+        value = static_cast<T>((value & 0x01) ? (value >> 1) ^ reflected_polynomial : (value >> 1));
+      }
+      tables[0][i] = value;
+    } else {
+      auto value = static_cast<T>(static_cast<T>(i) << (width - 8));
+      for (std::size_t bit = 0; bit < 8; ++bit) {
+        value = static_cast<T>((value & top_bit) ? (value << 1) ^ polynomial : (value << 1));
+      }
+      tables[0][i] = value;
+    }
+  }
+
+  for (std::size_t k = 1; k < N; ++k) {
+    for (std::size_t i = 0; i < 256; ++i) {
+      const T previous = tables[k - 1][i];
+
+      if (reflected) {
+        tables[k][i] = static_cast<T>(tables[0][previous & 0xFF] ^ shift_right(previous));
+      } else {
+        tables[k][i] = static_cast<T>(tables[0][(previous >> (width - 8)) & 0xFF] ^ shift_left(previous));
+      }
+    }
+  }
+
+  return tables;
+}
+
+}  // namespace crc_detail
+
+/// A table-driven CRC algorithm whose lookup tables are generated at compile time. The algorithm is parameterized by
+/// its polynomial, initial value, final XOR value, and input/result reflection. Reflected inputs are handled by
+/// generating a reflected lookup table, so individual bytes never need to be reflected.
+template <
+  std::unsigned_integral T,
+  T Polynomial,
+  T InitialValue,
+  T FinalXorValue,
+  bool InputReflected,
+  bool ResultReflected>
+class Crc
+{
+public:
+  /// The number of bits in the CRC value.
+  static constexpr std::size_t WIDTH = 8 * sizeof(T);
+
+  /// The largest number of bytes that can be processed in a single step by the slicing algorithm.
+  static constexpr std::size_t MAX_SLICES = 8;
+
+  /// The initial state of a running CRC calculation.
+  static constexpr T INITIAL_STATE = InputReflected ? crc_detail::reflect(InitialValue, WIDTH) : InitialValue;
+
+  /// Update a running CRC calculation with a single byte.
+  [[nodiscard]] static constexpr auto update(T state, std::uint8_t byte) -> T
+  {
+    if constexpr (InputReflected) {
+      return static_cast<T>(TABLES[0][(state ^ byte) & 0xFF] ^ crc_detail::shift_right(state));
+    } else {
+      return static_cast<T>(TABLES[0][((state >> (WIDTH - 8)) ^ byte) & 0xFF] ^ crc_detail::shift_left(state));
+    }
+  }
+
+  /// Update a running CRC calculation with a buffer of bytes, processing one byte at a time.
+  [[nodiscard]] static constexpr auto update(T state, std::span<const std::uint8_t> data) -> T
+  {
+    for (const std::uint8_t byte : data) {
+      state = update(state, byte);
+    }
+    return state;
+  }
+
+  /// Update a running CRC calculation with a buffer of bytes, processing N bytes at a time (slicing-by-N).
+  template <std::size_t N>
+  [[nodiscard]] static constexpr auto update_sliced(T state, std::span<const std::uint8_t> data) -> T
+  {
+    static_assert(N > 0 && N <= MAX_SLICES, "The number of slices must be in the range [1, 8].");
+    static_assert(sizeof(T) <= N, "The CRC value must fit in a single slice.");
+
+    std::size_t i = 0;
+
+    for (; i + N <= data.size(); i += N) {
+      std::uint64_t word = 0;
+      T next = 0;
+
+      if constexpr (InputReflected) {
+        // The CRC state overlaps the first bytes of the slice
+        for (std::size_t j = 0; j < N; ++j) {
+          word |= static_cast<std::uint64_t>(data[i + j]) << (8 * j);
+        }
+        word ^= state;
+
+        for (std::size_t j = 0; j < N; ++j) {
+          next ^= TABLES[N - 1 - j][(word >> (8 * j)) & 0xFF];
+        }
+      } else {
+        // The CRC state overlaps the last bytes of the slice
+        for (std::size_t j = 0; j < N; ++j) {
+          word = (word << 8) | data[i + j];
+        }
+        word ^= static_cast<std::uint64_t>(state) << (8 * N - WIDTH);
+
+        for (std::size_t j = 0; j < N; ++j) {
+          next ^= TABLES[j][(word >> (8 * j)) & 0xFF];
+        }
+      }
+
+      state = next;
+    }
+
+    return update(state, data.subspan(i));
+  }
+
+  /// Get the CRC value for a running CRC calculation.
+  [[nodiscard]] static constexpr auto finalize(T state) -> T
+  {
+    // The state of a reflected calculation is already reflected
+    if constexpr (InputReflected != ResultReflected) {
+      state = crc_detail::reflect(state, WIDTH);
+    }
+    return static_cast<T>(state ^ FinalXorValue);
+  }
+
+  /// Calculate the CRC value for a buffer of bytes. Longer buffers are processed using slicing-by-8.
+  [[nodiscard]] static constexpr auto calculate(std::span<const std::uint8_t> data) -> T
+  {
+    if (data.size() >= 2 * MAX_SLICES) {
+      return finalize(update_sliced<MAX_SLICES>(INITIAL_STATE, data));
+    }
+    return finalize(update(INITIAL_STATE, data));
+  }
+
+private:
+  static constexpr std::array<std::array<T, 256>, MAX_SLICES> TABLES =
+    crc_detail::make_tables<T, MAX_SLICES>(Polynomial, InputReflected);
+};
+
+/// The CRC8 algorithm used by Reach devices:
+///   - Polynomial: 0x4D
+///   - Initial Value: 0x00
+///   - Final XOR Value: 0xFF
+///   - Input Reflected: True
+///   - Result Reflected: True
+using ReachCrc = Crc<std::uint8_t, 0x4D, 0x00, 0xFF, true, true>;
+
 /// Calculate the CRC value for a packet.
-auto calculate_crc(const std::vector<std::uint8_t> & data) -> std::uint8_t;
+auto calculate_crc(std::span<const std::uint8_t> data) -> std::uint8_t;
+
+/// The initial value of a running CRC calculation.
+inline constexpr std::uint8_t CRC_INITIAL_VALUE = ReachCrc::INITIAL_STATE;
+
+/// Update a running CRC calculation with a single byte.
+constexpr auto update_crc(std::uint8_t crc, std::uint8_t byte) -> std::uint8_t { return ReachCrc::update(crc, byte); }
+
+/// Get the CRC value for a running CRC calculation.
+constexpr auto finalize_crc(std::uint8_t crc) -> std::uint8_t { return ReachCrc::finalize(crc); }
 
 }  // namespace libreach::protocol
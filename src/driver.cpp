@@ -25,48 +25,137 @@
 
 #include "libreach/driver.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <optional>
 #include <ranges>
 #include <stdexcept>
 
+#include "mpmc_queue.hpp"
+
 namespace libreach
 {
 
-namespace
+struct ReachDriver::PacketQueue
 {
+  PacketQueue(std::size_t capacity, std::size_t n_workers)
+  : packets(capacity),
+    n_workers(n_workers)
+  {
+  }
 
-template <typename T>
-auto inline convert_to_bytes(T value) -> std::vector<std::uint8_t>
-{
-  std::vector<std::uint8_t> bytes(sizeof(value));
-  std::memcpy(bytes.data(), &value, sizeof(value));
-  return bytes;
-}
+  /// Claim one of the available packets, if any. A packet is only popped by the thread that claimed it.
+  auto try_claim() -> bool
+  {
+    std::uint32_t n_available = available.load(std::memory_order_relaxed);
+    while (n_available > 0) {
+      if (available.compare_exchange_weak(n_available, n_available - 1, std::memory_order_acquire)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Pop a claimed packet. The packet at the front may still be being written by a producer, in which case this waits
+  /// for it to be finished unless the driver is stopped.
+  auto pop_claimed(const std::atomic<bool> & running) -> std::optional<Packet>
+  {
+    while (running.load(std::memory_order_relaxed)) {
+      if (auto packet = packets.try_pop()) {
+        return packet;
+      }
+      std::this_thread::yield();
+    }
+    return std::nullopt;
+  }
+
+  MpmcQueue<Packet> packets;
 
-auto inline merge_bytes(const std::vector<std::uint8_t> & first, const std::vector<std::uint8_t> & second)
-  -> std::vector<std::uint8_t>
+  // The number of packets in the queue that have not been claimed, which the idle workers wait on.
+  std::atomic<std::uint32_t> available{0};
+
+  // The number of workers that process the packets in the queue.
+  std::size_t n_workers;
+};
+
+struct ReachDriver::TransmitQueue
 {
-  std::vector<std::uint8_t> bytes(first.size() + second.size());
+  static constexpr std::size_t CAPACITY = 256;
+
+  /// Reserve space for the given number of packets in one of the queues, returning false if there is not enough space.
+  static auto try_reserve(std::atomic<std::size_t> & n_reserved, std::size_t n_packets) -> bool
+  {
+    std::size_t reserved = n_reserved.load(std::memory_order_relaxed);
+    do {
+      if (reserved + n_packets > CAPACITY) {
+        return false;
+      }
+    } while (!n_reserved.compare_exchange_weak(reserved, reserved + n_packets, std::memory_order_acq_rel));
+    return true;
+  }
 
-  std::ranges::copy(first, std::back_inserter(bytes));
-  std::ranges::copy(second, std::back_inserter(bytes));
+  // Commands (e.g., setpoints) are given priority over the diagnostic requests.
+  MpmcQueue<Packet> commands{CAPACITY};
+  MpmcQueue<Packet> requests{CAPACITY};
 
-  return bytes;
-}
+  // The space reserved in each queue, which is released once the writer thread has removed the packets. A batch is
+  // only queued once space has been reserved for all of its packets, so that it is never queued in part.
+  std::atomic<std::size_t> n_commands{0};
+  std::atomic<std::size_t> n_requests{0};
+
+  // The number of packets that have been added to the queues, which the writer thread waits on.
+  std::atomic<std::uint32_t> pending{0};
 
-}  // namespace
+  // The packets written by the writer thread on each iteration; this is only accessed by the writer thread.
+  std::vector<Packet> batch;
+};
 
-ReachDriver::ReachDriver(std::unique_ptr<protocol::Client> client, std::size_t q_size, std::size_t n_workers)
+ReachDriver::ReachDriver(
+  std::unique_ptr<protocol::Client> client,
+  std::size_t q_size,
+  std::size_t n_workers,
+  TransmitMode transmit_mode,
+  DispatchMode dispatch_mode)
 : client_(std::move(client)),
-  packets_(boost::circular_buffer<Packet>(q_size))
+  dispatch_mode_(dispatch_mode),
+  reader_epochs_(n_workers)
 {
+  if (dispatch_mode != DispatchMode::ANY_WORKER && n_workers > MAX_ORDERED_WORKERS) {
+    throw std::invalid_argument(
+      "Packets can only be dispatched per device to at most " + std::to_string(MAX_ORDERED_WORKERS) + " workers.");
+  }
+
   running_.store(true);
 
+  if (transmit_mode == TransmitMode::ASYNCHRONOUS) {
+    transmit_queue_ = std::make_unique<TransmitQueue>();
+    transmit_queue_->batch.reserve(2 * TransmitQueue::CAPACITY);
+
+    writer_thread_ = std::thread([this] {
+      while (running_.load()) {
+        process_transmit_queue();
+      }
+    });
+  }
+
+  // There is always at least one queue so that packets can be received without any workers
+  if (dispatch_mode == DispatchMode::ANY_WORKER || n_workers <= 1) {
+    dispatch_mode_ = DispatchMode::ANY_WORKER;
+    packet_queues_.push_back(std::make_unique<PacketQueue>(q_size, n_workers));
+  } else {
+    for (std::size_t i = 0; i < n_workers; ++i) {
+      packet_queues_.push_back(std::make_unique<PacketQueue>(q_size, 1));
+    }
+  }
+
   packet_threads_.reserve(n_workers);
   for (std::size_t i = 0; i < n_workers; ++i) {
-    packet_threads_.emplace_back([this] {
+    PacketQueue & queue = *packet_queues_[i % packet_queues_.size()];
+    ReaderEpoch & epoch = reader_epochs_[i];
+    packet_threads_.emplace_back([this, &queue, &epoch] {
       while (running_.load()) {
-        process_packet();
+        process_packet(queue, epoch);
       }
     });
   }
@@ -76,13 +165,23 @@ ReachDriver::ReachDriver(std::unique_ptr<protocol::Client> client, std::size_t q
       process_requests();
     }
   });
+
+  // The client is already running, so packets are only passed to the driver once it is ready to queue them
+  if (!client_->has_packet_callback()) {
+    client_->set_packet_batch_callback([this](std::span<const Packet> packets) { receive_packets(packets); });
+  }
 }
 
 ReachDriver::~ReachDriver()
 {
   running_.store(false);
 
-  packets_cv_.notify_all();
+  // Wake up the workers so that they can observe the shutdown. Each worker of a queue is given a token of its own;
+  // otherwise, one worker could take the only token while another is about to wait for one.
+  for (auto & queue : packet_queues_) {
+    queue->available.fetch_add(static_cast<std::uint32_t>(queue->n_workers));
+    queue->available.notify_all();
+  }
   for (auto & thread : packet_threads_) {
     if (thread.joinable()) {
       thread.join();
@@ -93,49 +192,92 @@ ReachDriver::~ReachDriver()
   if (request_scheduler_thread_.joinable()) {
     request_scheduler_thread_.join();
   }
+
+  if (transmit_queue_ != nullptr) {
+    // Wake up the writer thread so that it can observe the shutdown
+    transmit_queue_->pending.fetch_add(1);
+    transmit_queue_->pending.notify_one();
+  }
+  if (writer_thread_.joinable()) {
+    writer_thread_.join();
+  }
+
+  // The client may still be receiving packets, so it is destroyed before the packet queues
+  client_.reset();
+}
+
+template <PacketId Id>
+auto ReachDriver::send_commands(std::span<const std::pair<std::uint8_t, float>> commands) const -> void
+{
+  // The commands are encoded as they are written (or queued), so sending setpoints does not allocate
+  const auto make_command = [commands](std::size_t i) {
+    return make_packet<Id>(commands[i].first, commands[i].second);
+  };
+
+  if (!client_->connected()) {
+    throw std::runtime_error("Unable to send packets. Client is not connected.");
+  }
+
+  if (transmit_queue_ != nullptr) {
+    reserve_transmit_queue(commands.size(), 0);
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+      queue_packet(make_command(i));
+    }
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(send_packet_lock_);
+  client_->send_packets(commands.size(), make_command);
 }
 
 auto ReachDriver::set_mode(std::uint8_t device_id, Mode mode) const -> void
 {
-  send_packet(PacketId::MODE, device_id, {static_cast<uint8_t>(mode)});
+  send_packet<PacketId::MODE>(device_id, mode);
 }
 
 auto ReachDriver::set_velocity(std::uint8_t device_id, float velocity) const -> void
 {
-  send_packet(PacketId::VELOCITY, device_id, convert_to_bytes<float>(velocity));
+  send_packet<PacketId::VELOCITY>(device_id, velocity);
+}
+
+auto ReachDriver::set_velocity(std::span<const std::pair<std::uint8_t, float>> velocities) const -> void
+{
+  send_commands<PacketId::VELOCITY>(velocities);
 }
 
 auto ReachDriver::set_position(std::uint8_t device_id, float position) const -> void
 {
-  send_packet(PacketId::POSITION, device_id, convert_to_bytes<float>(position));
+  send_packet<PacketId::POSITION>(device_id, position);
+}
+
+auto ReachDriver::set_position(std::span<const std::pair<std::uint8_t, float>> positions) const -> void
+{
+  send_commands<PacketId::POSITION>(positions);
 }
 
 auto ReachDriver::set_relative_position(std::uint8_t device_id, float relative_position) const -> void
 {
-  send_packet(PacketId::RELATIVE_POSITION, device_id, convert_to_bytes<float>(relative_position));
+  send_packet<PacketId::RELATIVE_POSITION>(device_id, relative_position);
 }
 
 auto ReachDriver::set_current(std::uint8_t device_id, float current) const -> void
 {
-  send_packet(PacketId::CURRENT, device_id, convert_to_bytes<float>(current));
+  send_packet<PacketId::CURRENT>(device_id, current);
 }
 
 auto ReachDriver::set_position_limits(std::uint8_t device_id, float min_position, float max_position) const -> void
 {
-  auto range = merge_bytes(convert_to_bytes<float>(min_position), convert_to_bytes<float>(max_position));
-  send_packet(PacketId::POSITION_LIMITS, device_id, range);
+  send_packet<PacketId::POSITION_LIMITS>(device_id, min_position, max_position);
 }
 
 auto ReachDriver::set_velocity_limits(std::uint8_t device_id, float min_velocity, float max_velocity) const -> void
 {
-  auto range = merge_bytes(convert_to_bytes<float>(min_velocity), convert_to_bytes<float>(max_velocity));
-  send_packet(PacketId::VELOCITY_LIMITS, device_id, range);
+  send_packet<PacketId::VELOCITY_LIMITS>(device_id, min_velocity, max_velocity);
 }
 
 auto ReachDriver::set_current_limits(std::uint8_t device_id, float min_current, float max_current) const -> void
 {
-  auto range = merge_bytes(convert_to_bytes<float>(min_current), convert_to_bytes<float>(max_current));
-  send_packet(PacketId::CURRENT_LIMITS, device_id, range);
+  send_packet<PacketId::CURRENT_LIMITS>(device_id, min_current, max_current);
 }
 
 auto ReachDriver::request(PacketId packet_id, std::uint8_t device_id) const -> void
@@ -153,7 +295,8 @@ auto ReachDriver::request(const std::vector<PacketId> & packet_ids, std::uint8_t
     throw std::invalid_argument("Cannot request more than 10 packets at a time.");
   }
 
-  std::vector<std::uint8_t> request_types(packet_ids.size());
+  std::vector<std::uint8_t> request_types;
+  request_types.reserve(packet_ids.size());
 
   for (auto id : packet_ids) {
     request_types.push_back(static_cast<std::uint8_t>(id));
@@ -189,7 +332,8 @@ auto ReachDriver::request_at_rate(
   {
     const std::lock_guard<std::mutex> lock(request_lock_);
 
-    std::vector<std::uint8_t> request_types(packet_ids.size());
+    std::vector<std::uint8_t> request_types;
+    request_types.reserve(packet_ids.size());
 
     for (auto id : packet_ids) {
       request_types.push_back(static_cast<std::uint8_t>(id));
@@ -201,13 +345,112 @@ auto ReachDriver::request_at_rate(
   request_cv_.notify_all();
 }
 
-auto ReachDriver::register_callback(PacketId packet_id, std::function<void(const Packet &)> && callback) -> void
+auto ReachDriver::decode_statistics() const -> protocol::DecodeStatistics { return client_->decode_statistics(); }
+
+auto ReachDriver::register_connection_callback(std::function<void(bool)> && callback) const -> void
+{
+  client_->register_connection_callback(std::move(callback));
+}
+
+auto ReachDriver::set_heartbeat_frequency(std::uint8_t frequency) const -> void
+{
+  client_->set_heartbeat_frequency(frequency);
+}
+
+auto ReachDriver::start_capture(const std::string & path) const -> void { client_->start_capture(path); }
+
+auto ReachDriver::stop_capture() const -> void { client_->stop_capture(); }
+
+auto ReachDriver::register_callback(PacketId packet_id, std::function<void(PacketView)> && callback) -> CallbackHandle
+{
+  CallbackHandle handle{packet_id, 0};
+
+  {
+    const std::lock_guard<std::mutex> lock(callbacks_lock_);
+    const auto & current = subscribers_[static_cast<std::uint8_t>(packet_id)];
+
+    auto subscribers = current ? std::make_unique<Subscribers>(*current) : std::make_unique<Subscribers>();
+    handle.id = next_callback_id_++;
+    subscribers->push_back(Subscriber{handle.id, std::move(callback)});
+
+    publish_callbacks(packet_id, std::move(subscribers));
+  }
+
+  reclaim_callbacks();
+
+  return handle;
+}
+
+auto ReachDriver::unregister_callback(CallbackHandle handle) -> void
+{
+  {
+    const std::lock_guard<std::mutex> lock(callbacks_lock_);
+    const auto & current = subscribers_[static_cast<std::uint8_t>(handle.packet_id)];
+
+    if (!current || std::ranges::none_of(*current, [&handle](const auto & s) { return s.id == handle.id; })) {
+      return;
+    }
+
+    auto subscribers = std::make_unique<Subscribers>();
+    subscribers->reserve(current->size() - 1);
+    std::ranges::copy_if(*current, std::back_inserter(*subscribers), [&handle](const auto & s) {
+      return s.id != handle.id;
+    });
+
+    publish_callbacks(handle.packet_id, subscribers->empty() ? nullptr : std::move(subscribers));
+  }
+
+  // Once the workers have finished reading the previous list, the callback can no longer be running
+  reclaim_callbacks();
+}
+
+auto ReachDriver::publish_callbacks(PacketId packet_id, std::unique_ptr<const Subscribers> subscribers) -> void
+{
+  const auto index = static_cast<std::uint8_t>(packet_id);
+
+  callbacks_[index].store(subscribers.get());
+
+  if (subscribers_[index]) {
+    retired_subscribers_.push_back(std::move(subscribers_[index]));
+  }
+  subscribers_[index] = std::move(subscribers);
+}
+
+auto ReachDriver::reclaim_callbacks() -> void
 {
-  callbacks_[packet_id].emplace_back(std::move(callback));
+  const auto this_thread = std::this_thread::get_id();
+  if (std::ranges::any_of(packet_threads_, [this_thread](const auto & t) { return t.get_id() == this_thread; })) {
+    return;
+  }
+
+  std::vector<std::unique_ptr<const Subscribers>> retired;
+  {
+    const std::lock_guard<std::mutex> lock(callbacks_lock_);
+    retired.swap(retired_subscribers_);
+  }
+
+  // The lists were removed from the table before this point, so a worker that is dispatching a packet now may only be
+  // reading one of them if it started before; wait for each of those workers to finish dispatching their packet. This
+  // is done without holding the lock so that the callbacks themselves can (un)register callbacks. The wait is needed
+  // even if there is nothing to delete: another thread may have taken the list that this thread retired, and the
+  // callback that was removed must not be running once it has been unregistered.
+  for (auto & epoch : reader_epochs_) {
+    const std::uint64_t value = epoch.value.load();
+    if (value % 2 == 1) {
+      while (epoch.value.load(std::memory_order_acquire) == value) {
+        std::this_thread::yield();
+      }
+    }
+  }
 }
 
 auto ReachDriver::send_packet(const Packet & packet) const -> void  // NOLINT
 {
+  if (transmit_queue_ != nullptr) {
+    send_packets(std::span(&packet, 1));
+    return;
+  }
+
   if (!client_->connected()) {
     throw std::runtime_error("Unable to send packet. Client is not connected.");
   }
@@ -222,47 +465,167 @@ auto ReachDriver::send_packet(PacketId packet_id, std::uint8_t device_id, const
   send_packet(Packet(packet_id, device_id, data));
 }
 
-auto ReachDriver::receive_packet(const Packet & packet) -> void
+auto ReachDriver::send_packets(std::span<const Packet> packets) const -> void
 {
-  {
-    const std::lock_guard<std::mutex> lock(packets_lock_);
-    packets_.push_back(packet);
+  if (transmit_queue_ == nullptr) {
+    write_packets(packets);
+    return;
+  }
+
+  if (!client_->connected()) {
+    throw std::runtime_error("Unable to send packets. Client is not connected.");
+  }
+
+  const auto n_requests = static_cast<std::size_t>(std::ranges::count_if(
+    packets, [](const Packet & packet) { return packet.packet_id() == PacketId::REQUEST; }));
+  reserve_transmit_queue(packets.size() - n_requests, n_requests);
+
+  for (const auto & packet : packets) {
+    queue_packet(packet);
   }
-  packets_cv_.notify_one();
 }
 
-auto ReachDriver::receive_packets(const std::vector<Packet> & packets) -> void
+auto ReachDriver::reserve_transmit_queue(std::size_t n_commands, std::size_t n_requests) const -> void
 {
-  {
-    const std::lock_guard<std::mutex> lock(packets_lock_);
-    std::ranges::copy(packets, std::back_inserter(packets_));
+  auto & queue = *transmit_queue_;
+
+  if (!TransmitQueue::try_reserve(queue.n_commands, n_commands)) {
+    throw std::runtime_error("Unable to send packets. The transmit queue does not have space for all of them.");
+  }
+
+  if (!TransmitQueue::try_reserve(queue.n_requests, n_requests)) {
+    queue.n_commands.fetch_sub(n_commands, std::memory_order_release);
+    throw std::runtime_error("Unable to send packets. The transmit queue does not have space for all of them.");
   }
-  packets_cv_.notify_all();
 }
 
-auto ReachDriver::process_packet() -> void
+auto ReachDriver::queue_packet(const Packet & packet) const -> void
 {
-  std::unique_lock<std::mutex> lock(packets_lock_);
-  packets_cv_.wait(lock, [this] { return !packets_.empty() || !running_.load(); });
+  auto & queue = packet.packet_id() == PacketId::REQUEST ? transmit_queue_->requests : transmit_queue_->commands;
 
-  if (!running_.load()) {
+  // The pending count is incremented first so that the writer never removes more packets than it has counted
+  transmit_queue_->pending.fetch_add(1);
+
+  // Space has been reserved for the packet, so the queue cannot be full
+  queue.try_push(packet);
+
+  transmit_queue_->pending.notify_one();
+}
+
+auto ReachDriver::write_packets(std::span<const Packet> packets) const -> void
+{
+  if (!client_->connected()) {
+    throw std::runtime_error("Unable to send packets. Client is not connected.");
+  }
+
+  const std::lock_guard<std::mutex> lock(send_packet_lock_);
+  client_->send_packets(packets);
+}
+
+auto ReachDriver::receive_packets(std::span<const Packet> packets) -> void
+{
+  if (dispatch_mode_ == DispatchMode::ANY_WORKER) {
+    PacketQueue & queue = *packet_queues_.front();
+    for (const Packet & packet : packets) {
+      enqueue_packet(queue, packet);
+    }
+    notify_workers(queue, static_cast<std::uint32_t>(packets.size()));
     return;
   }
 
-  const Packet packet = std::move(packets_.front());
-  packets_.pop_front();
+  // The packets are spread across the queues, so each queue's workers are woken once the whole batch has been added.
+  // The counts are kept on the stack because the transports of a redundant client may deliver batches concurrently.
+  std::array<std::uint32_t, MAX_ORDERED_WORKERS> n_enqueued{};
+  for (const Packet & packet : packets) {
+    const std::size_t index = queue_index(packet);
+    enqueue_packet(*packet_queues_[index], packet);
+    ++n_enqueued[index];
+  }
+  for (std::size_t i = 0; i < packet_queues_.size(); ++i) {
+    notify_workers(*packet_queues_[i], n_enqueued[i]);
+  }
+}
+
+auto ReachDriver::queue_index(PacketView packet) const -> std::size_t
+{
+  if (dispatch_mode_ == DispatchMode::ANY_WORKER) {
+    return 0;
+  }
 
-  lock.unlock();
+  // Device IDs (and the packet IDs requested from them) are usually consecutive, so a sum spreads them evenly
+  std::size_t key = packet.device_id();
+  if (dispatch_mode_ == DispatchMode::PER_DEVICE_AND_PACKET) {
+    key += static_cast<std::uint8_t>(packet.packet_id());
+  }
 
-  auto it = callbacks_.find(packet.packet_id());
+  return key % packet_queues_.size();
+}
 
-  if (it != callbacks_.end()) {
-    for (const auto & callback : it->second) {
-      callback(packet);
+auto ReachDriver::enqueue_packet(PacketQueue & queue, const Packet & packet) -> void
+{
+  while (!queue.packets.try_push(packet)) {
+    if (!running_.load()) {
+      return;
+    }
+
+    // The queue is full, so the oldest packet is dropped; if every packet has been claimed, a worker is about to pop
+    // one and the push is simply retried
+    if (queue.try_claim() && !queue.pop_claimed(running_)) {
+      // The driver is stopping, so the claimed token may be one of the workers' shutdown tokens; give it back
+      queue.available.fetch_add(1);
+      queue.available.notify_all();
+      return;
+    }
+  }
+
+  // Each packet is made available as soon as it is added, so the oldest packets of a batch that is larger than the
+  // queue can be claimed and dropped before the rest of the batch is added
+  queue.available.fetch_add(1, std::memory_order_release);
+}
+
+auto ReachDriver::notify_workers(PacketQueue & queue, std::uint32_t n_packets) -> void
+{
+  if (n_packets == 0) {
+    return;
+  }
+
+  // Only wake as many workers as there are packets to process instead of having every worker compete for them. The
+  // notifications do not make a system call when no worker is waiting.
+  if (n_packets >= queue.n_workers) {
+    queue.available.notify_all();
+  } else {
+    for (std::uint32_t i = 0; i < n_packets; ++i) {
+      queue.available.notify_one();
     }
   }
 }
 
+auto ReachDriver::process_packet(PacketQueue & queue, ReaderEpoch & epoch) -> void
+{
+  if (!queue.try_claim()) {
+    queue.available.wait(0);
+    return;
+  }
+
+  const std::optional<Packet> packet = queue.pop_claimed(running_);
+
+  if (!packet) {
+    return;
+  }
+
+  epoch.value.fetch_add(1);
+
+  const Subscribers * subscribers = callbacks_[static_cast<std::uint8_t>(packet->packet_id())].load();
+
+  if (subscribers != nullptr) {
+    for (const auto & subscriber : *subscribers) {
+      subscriber.callback(*packet);
+    }
+  }
+
+  epoch.value.fetch_add(1, std::memory_order_release);
+}
+
 auto ReachDriver::process_requests() -> void
 {
   std::unique_lock<std::mutex> lock(request_lock_);
@@ -274,17 +637,69 @@ auto ReachDriver::process_requests() -> void
 
   auto now = std::chrono::steady_clock::now();
 
+  // Requests that are due at the same time are written together
+  due_requests_.clear();
   for (auto & request : requests_) {
     if (request.next_request <= now) {
-      send_packet(request.packet);
+      due_requests_.push_back(request.packet);
       request.next_request = now + request.rate;
     }
   }
 
+  // Requests that are due while the client is disconnected are skipped, so that the schedule resumes at the same
+  // rate once the client reconnects
+  if (!due_requests_.empty() && client_->connected()) {
+    try {
+      send_packets(due_requests_);
+    }
+    catch (const std::exception & e) {
+      std::cout << "Failed to send the scheduled requests: " << e.what() << "\n";
+    }
+  }
+
   // Wait for the earliest request to be ready
   request_cv_.wait_until(lock, std::ranges::min_element(requests_, [](const Request & a, const Request & b) {
                                  return a.next_request < b.next_request;
                                })->next_request);
 }
 
+auto ReachDriver::process_transmit_queue() -> void
+{
+  auto & queue = *transmit_queue_;
+  queue.pending.wait(0);
+
+  if (!running_.load()) {
+    return;
+  }
+
+  // Drain the commands before the requests so that they are written first
+  queue.batch.clear();
+  while (auto packet = queue.commands.try_pop()) {
+    queue.batch.push_back(*packet);
+  }
+  const std::size_t n_commands = queue.batch.size();
+  while (auto packet = queue.requests.try_pop()) {
+    queue.batch.push_back(*packet);
+  }
+
+  // The packets have been removed, so their space can be reserved by new batches
+  queue.n_commands.fetch_sub(n_commands, std::memory_order_release);
+  queue.n_requests.fetch_sub(queue.batch.size() - n_commands, std::memory_order_release);
+
+  if (queue.batch.empty()) {
+    // A producer has counted a packet that it has not finished adding yet
+    std::this_thread::yield();
+    return;
+  }
+
+  queue.pending.fetch_sub(static_cast<std::uint32_t>(queue.batch.size()));
+
+  try {
+    write_packets(queue.batch);
+  }
+  catch (const std::exception & e) {
+    std::cout << "Failed to write " << queue.batch.size() << " queued packets: " << e.what() << "\n";
+  }
+}
+
 }  // namespace libreach
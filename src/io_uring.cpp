@@ -0,0 +1,467 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "io_uring.hpp"
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "libreach/client.hpp"
+
+namespace libreach::protocol
+{
+
+namespace
+{
+
+auto io_uring_setup(std::uint32_t entries, io_uring_params * params) -> int
+{
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto io_uring_enter(int ring_fd, std::uint32_t to_submit) -> int
+{
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, 0, 0, nullptr, 0));
+}
+
+// The time allowed for the requests in flight to complete once they have been cancelled.
+const int CANCEL_TIMEOUT_MS = 100;
+const int CANCEL_ATTEMPTS = 10;
+
+auto io_uring_register(int ring_fd, std::uint32_t opcode, const void * arg, std::uint32_t n_args) -> int
+{
+  return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, n_args));
+}
+
+/// Get a pointer to a member of a ring given its offset in the shared memory.
+template <typename T>
+auto ring_member(void * ring, std::uint32_t offset) -> T *
+{
+  return reinterpret_cast<T *>(static_cast<std::uint8_t *>(ring) + offset);
+}
+
+}  // namespace
+
+auto IoUring::create(int fd, std::size_t read_size) -> std::unique_ptr<IoUring>
+{
+  // The constructor throws if any part of the ring cannot be set up; the caller should then use regular reads/writes
+  try {
+    return std::unique_ptr<IoUring>(new IoUring(fd, read_size));
+  }
+  catch (const std::exception & e) {
+    std::cout << "io_uring is unavailable; falling back to regular reads and writes: " << e.what() << "\n";
+    return nullptr;
+  }
+}
+
+IoUring::IoUring(int fd, std::size_t read_size)
+: fd_(fd),
+  read_buffer_(read_size),
+  write_buffers_(N_WRITE_BUFFERS * MAX_WRITE_SIZE)
+{
+  // Each read from a datagram socket receives exactly one datagram
+  int socket_type = 0;
+  socklen_t socket_type_size = sizeof(socket_type);
+  reads_datagrams_ = getsockopt(fd, SOL_SOCKET, SO_TYPE, &socket_type, &socket_type_size) == 0 &&
+                     socket_type == SOCK_DGRAM;
+
+  ring_fd_ = io_uring_setup(32, &params_);
+  if (ring_fd_ < 0) {
+    throw std::runtime_error(std::strerror(errno));
+  }
+
+  sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(std::uint32_t);
+  cq_ring_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+
+  // Newer kernels map both rings with a single mmap
+  if ((params_.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ring_ =
+    mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    release();
+    throw std::runtime_error("Failed to map the submission queue.");
+  }
+
+  if ((params_.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ =
+      mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      release();
+      throw std::runtime_error("Failed to map the completion queue.");
+    }
+  }
+
+  void * sqes = mmap(
+    nullptr,
+    params_.sq_entries * sizeof(io_uring_sqe),
+    PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE,
+    ring_fd_,
+    IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    release();
+    throw std::runtime_error("Failed to map the submission queue entries.");
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  sq_head_ = ring_member<std::uint32_t>(sq_ring_, params_.sq_off.head);
+  sq_tail_ = ring_member<std::uint32_t>(sq_ring_, params_.sq_off.tail);
+  sq_array_ = ring_member<std::uint32_t>(sq_ring_, params_.sq_off.array);
+  cq_head_ = ring_member<std::uint32_t>(cq_ring_, params_.cq_off.head);
+  cq_tail_ = ring_member<std::uint32_t>(cq_ring_, params_.cq_off.tail);
+  cqes_ = ring_member<io_uring_cqe>(cq_ring_, params_.cq_off.cqes);
+
+  // Registering the buffers lets the kernel skip mapping them on every request
+  std::array<struct iovec, N_WRITE_BUFFERS + 1> buffers;
+  buffers[0] = {read_buffer_.data(), read_buffer_.size()};
+  for (std::size_t i = 0; i < N_WRITE_BUFFERS; ++i) {
+    buffers[i + 1] = {write_buffers_.data() + (i * MAX_WRITE_SIZE), MAX_WRITE_SIZE};
+  }
+
+  if (io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) < 0) {
+    const std::string error = std::strerror(errno);
+    release();
+    throw std::runtime_error("Failed to register buffers: " + error);
+  }
+
+  if (!submit_read()) {
+    release();
+    throw std::runtime_error("Failed to submit the initial read.");
+  }
+}
+
+IoUring::~IoUring()
+{
+  if (!cancel_requests()) {
+    // Freeing the buffers while the kernel may still write into them would corrupt whatever reuses the memory, so they
+    // are leaked instead
+    std::cout << "The io_uring requests could not be cancelled; their buffers will not be freed.\n";
+    new std::vector<std::uint8_t>(std::move(read_buffer_));    // NOLINT
+    new std::vector<std::uint8_t>(std::move(write_buffers_));  // NOLINT
+  }
+
+  release();
+}
+
+auto IoUring::cancel_requests() -> bool
+{
+  const auto cancel = [this](std::uint64_t request) {
+    io_uring_sqe cancellation = {};
+    cancellation.opcode = IORING_OP_ASYNC_CANCEL;
+    cancellation.addr = request;
+    cancellation.user_data = CANCEL_REQUEST;
+    submit(cancellation);
+  };
+
+  // Writes that are still queued are dropped; the write in flight is cancelled along with the read
+  {
+    const std::lock_guard<std::mutex> lock(write_lock_);
+    n_writes_ = write_in_flight_ ? 1 : 0;
+  }
+
+  if (read_posted_) {
+    cancel(READ_REQUEST);
+  }
+  if (write_in_flight_) {
+    cancel(WRITE_REQUEST);
+  }
+
+  for (int attempt = 0; (read_posted_ || write_in_flight_) && attempt < CANCEL_ATTEMPTS; ++attempt) {
+    struct pollfd fd = {ring_fd_, POLLIN, 0};
+    poll(&fd, 1, CANCEL_TIMEOUT_MS);
+
+    for_each_completion([this](const io_uring_cqe & completion) {
+      if (completion.user_data == READ_REQUEST) {
+        read_posted_ = false;
+      } else if (completion.user_data == WRITE_REQUEST) {
+        write_in_flight_ = false;
+      }
+    });
+  }
+
+  return !read_posted_ && !write_in_flight_;
+}
+
+auto IoUring::release() -> void
+{
+  if (sqes_ != nullptr) {
+    munmap(sqes_, params_.sq_entries * sizeof(io_uring_sqe));
+    sqes_ = nullptr;
+  }
+
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+auto IoUring::write(std::span<const std::uint8_t> data) -> ssize_t
+{
+  const std::lock_guard<std::mutex> lock(write_lock_);
+
+  if (write_error_ != 0) {
+    errno = write_error_;
+
+    // A datagram that could not be sent does not prevent later datagrams from being sent
+    if (reads_datagrams_) {
+      write_error_ = 0;
+    }
+    return -1;
+  }
+
+  if (reads_datagrams_ && data.size() > MAX_WRITE_SIZE) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+
+  // The data is either queued completely or not at all
+  if (!can_queue(data.size())) {
+    errno = ENOBUFS;
+    return -1;
+  }
+
+  std::span<const std::uint8_t> remaining = data;
+
+  while (!remaining.empty()) {
+    // Data written to a stream is appended to the last queued write unless that write is already in flight, while
+    // each datagram is written separately
+    const std::size_t last = (first_write_ + n_writes_ + N_WRITE_BUFFERS - 1) % N_WRITE_BUFFERS;
+    const bool append = !reads_datagrams_ && n_writes_ > 0 && !(n_writes_ == 1 && write_in_flight_) &&
+                        writes_[last].size < MAX_WRITE_SIZE;
+
+    const std::size_t index = append ? last : (first_write_ + n_writes_) % N_WRITE_BUFFERS;
+    if (!append) {
+      writes_[index] = WriteBuffer{};
+      ++n_writes_;
+    }
+
+    WriteBuffer & buffer = writes_[index];
+    const std::size_t size = std::min(remaining.size(), MAX_WRITE_SIZE - buffer.size);
+    std::memcpy(write_buffers_.data() + (index * MAX_WRITE_SIZE) + buffer.size, remaining.data(), size);
+    buffer.size += size;
+    remaining = remaining.subspan(size);
+  }
+
+  if (!write_in_flight_ && !submit_write()) {
+    n_writes_ = 0;
+    errno = EAGAIN;
+    return -1;
+  }
+
+  return static_cast<ssize_t>(data.size());
+}
+
+auto IoUring::process_completions(const std::function<void(std::span<const std::uint8_t>)> & on_read) -> bool
+{
+  bool reading = true;
+
+  for_each_completion([this, &on_read, &reading](const io_uring_cqe & completion) {
+    if (completion.user_data == WRITE_REQUEST) {
+      const std::lock_guard<std::mutex> lock(write_lock_);
+      complete_write(completion.res);
+      return;
+    }
+
+    if (completion.user_data != READ_REQUEST) {
+      return;
+    }
+
+    read_posted_ = false;
+
+    if (completion.res > 0) {
+      on_read(std::span(read_buffer_).first(static_cast<std::size_t>(completion.res)));
+    } else if (completion.res == 0 && !reads_datagrams_) {
+      // A stream (e.g., a serial port) only reports that no data was read once it has been hung up
+      reading = false;
+      return;
+    } else if (completion.res < 0 && completion.res != -EAGAIN && completion.res != -EINTR) {
+      std::cout << "Failed to read from the robot: " << std::strerror(-completion.res) << "\n";
+      if (!reads_datagrams_) {
+        reading = false;
+        return;
+      }
+    }
+
+    if (!submit_read()) {
+      std::cout << "Failed to submit a read to the io_uring.\n";
+      reading = false;
+    }
+  });
+
+  return reading;
+}
+
+auto IoUring::for_each_completion(const std::function<void(const io_uring_cqe &)> & callback) -> void
+{
+  // Only one thread consumes completions, so the head can be read without synchronization
+  std::uint32_t head = *cq_head_;
+  const std::uint32_t tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+
+  for (; head != tail; ++head) {
+    callback(cqes_[head & (params_.cq_entries - 1)]);
+  }
+
+  std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+}
+
+auto IoUring::can_queue(std::size_t size) const -> bool
+{
+  const std::size_t n_free = N_WRITE_BUFFERS - n_writes_;
+
+  if (reads_datagrams_) {
+    return n_free > 0;
+  }
+
+  // The last queued write can be appended to unless it is in flight
+  std::size_t available = n_free * MAX_WRITE_SIZE;
+  if (n_writes_ > 0 && !(n_writes_ == 1 && write_in_flight_)) {
+    available += MAX_WRITE_SIZE - writes_[(first_write_ + n_writes_ - 1) % N_WRITE_BUFFERS].size;
+  }
+
+  return size <= available;
+}
+
+auto IoUring::complete_write(int result) -> void
+{
+  write_in_flight_ = false;
+
+  if (n_writes_ == 0) {
+    return;
+  }
+
+  WriteBuffer & buffer = writes_[first_write_];
+
+  if (result == -EAGAIN || result == -EINTR) {
+    // The same data is submitted again
+  } else if (result < 0) {
+    write_error_ = -result;
+    std::cout << "Failed to send packet; the connection was likely lost: " << std::strerror(-result) << "\n";
+
+    // The remaining data cannot be written to a broken stream, while later datagrams may still be sent
+    if (!reads_datagrams_) {
+      n_writes_ = 0;
+      return;
+    }
+    buffer.written = buffer.size;
+  } else {
+    // A short write to a stream (e.g., a full socket buffer) is completed by submitting the rest of the data
+    buffer.written = reads_datagrams_ ? buffer.size : buffer.written + static_cast<std::size_t>(result);
+  }
+
+  if (buffer.written >= buffer.size) {
+    first_write_ = (first_write_ + 1) % N_WRITE_BUFFERS;
+    --n_writes_;
+  }
+
+  if (n_writes_ > 0 && !submit_write()) {
+    write_error_ = EAGAIN;
+    n_writes_ = 0;
+  }
+}
+
+auto IoUring::submit_write() -> bool
+{
+  const WriteBuffer & buffer = writes_[first_write_];
+  std::uint8_t * data = write_buffers_.data() + (first_write_ * MAX_WRITE_SIZE);
+
+  io_uring_sqe request = {};
+  request.opcode = IORING_OP_WRITE_FIXED;
+  request.fd = fd_;
+  request.addr = reinterpret_cast<std::uint64_t>(data + buffer.written);
+  request.len = static_cast<std::uint32_t>(buffer.size - buffer.written);
+  request.buf_index = static_cast<std::uint16_t>(first_write_ + 1);
+  request.user_data = WRITE_REQUEST;
+
+  write_in_flight_ = submit(request);
+  return write_in_flight_;
+}
+
+auto IoUring::submit_read() -> bool
+{
+  io_uring_sqe request = {};
+  request.opcode = IORING_OP_READ_FIXED;
+  request.fd = fd_;
+  request.addr = reinterpret_cast<std::uint64_t>(read_buffer_.data());
+  request.len = static_cast<std::uint32_t>(read_buffer_.size());
+  request.buf_index = 0;
+  request.user_data = READ_REQUEST;
+
+  read_posted_ = submit(request);
+  return read_posted_;
+}
+
+auto IoUring::submit(const io_uring_sqe & request) -> bool
+{
+  const std::lock_guard<std::mutex> lock(submission_lock_);
+
+  const std::uint32_t tail = *sq_tail_;
+  const std::uint32_t head = std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+
+  if (tail - head == params_.sq_entries) {
+    return false;
+  }
+
+  const std::uint32_t index = tail & (params_.sq_entries - 1);
+  sqes_[index] = request;
+  sq_array_[index] = index;
+
+  std::atomic_ref(*sq_tail_).store(tail + 1, std::memory_order_release);
+
+  // Without a kernel polling thread, the kernel needs to be told about new submissions; this does not wait for the
+  // request to complete. Requests that the kernel cannot accept yet remain queued and are submitted with the next one.
+  io_uring_enter(ring_fd_, tail + 1 - head);
+
+  return true;
+}
+
+}  // namespace libreach::protocol
@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/types.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace libreach::protocol
+{
+
+/// Performs reads and writes on a file descriptor using io_uring. A read is always kept posted into a registered buffer
+/// so that incoming data is received without issuing a read per poll, and writes are submitted without waiting for
+/// them to complete. The ring's file descriptor becomes readable whenever completions are available.
+///
+/// Writes are queued in registered buffers and only the oldest write is in flight at any time, so the data is written
+/// in the order that it was submitted even when the kernel performs the writes asynchronously.
+class IoUring
+{
+public:
+  /// Create a new ring for a connection, or return nullptr if io_uring is not supported by the kernel.
+  static auto create(int fd, std::size_t read_size) -> std::unique_ptr<IoUring>;
+
+  /// Cancel the requests that are in flight and release the ring once they have completed.
+  ~IoUring();
+
+  IoUring(const IoUring &) = delete;
+  auto operator=(const IoUring &) -> IoUring & = delete;
+
+  /// Get the file descriptor of the ring.
+  [[nodiscard]] auto ring_fd() const -> int { return ring_fd_; }
+
+  /// Check whether each completed read contains a single datagram.
+  [[nodiscard]] auto reads_datagrams() const -> bool { return reads_datagrams_; }
+
+  /// Queue data to be written to the connection and return the number of bytes queued, or -1 (setting errno) on
+  /// failure. The data is copied, so it does not need to outlive the call. A write fails if a previous write failed
+  /// (for a stream, every later write fails because the connection is broken) or if the write queue is full.
+  auto write(std::span<const std::uint8_t> data) -> ssize_t;
+
+  /// Process all available completions, executing a callback with the data of each completed read. This returns false
+  /// once the connection can no longer be read from (e.g., it was hung up).
+  auto process_completions(const std::function<void(std::span<const std::uint8_t>)> & on_read) -> bool;
+
+private:
+  // Identifies the request in a completion.
+  static constexpr std::uint64_t READ_REQUEST = 0;
+  static constexpr std::uint64_t WRITE_REQUEST = 1;
+  static constexpr std::uint64_t CANCEL_REQUEST = 2;
+
+  // The number of writes that can be queued at once.
+  static constexpr std::size_t N_WRITE_BUFFERS = 16;
+
+  // The amount of data stored in a write buffer and how much of it has been written so far.
+  struct WriteBuffer
+  {
+    std::size_t size{0};
+    std::size_t written{0};
+  };
+
+  IoUring(int fd, std::size_t read_size);
+
+  /// Release the ring and its shared memory.
+  auto release() -> void;
+
+  /// Cancel the requests that are in flight and wait for them to complete, so that the kernel no longer accesses the
+  /// registered buffers. This returns false if the requests did not complete in time.
+  auto cancel_requests() -> bool;
+
+  /// Execute a callback for each available completion and mark the completions as consumed.
+  auto for_each_completion(const std::function<void(const io_uring_cqe &)> & callback) -> void;
+
+  /// Check whether data can be added to the write queue; this must be called while holding the write lock.
+  [[nodiscard]] auto can_queue(std::size_t size) const -> bool;
+
+  /// Update the write queue once the write in flight has completed and submit the next write, if any; this must be
+  /// called while holding the write lock.
+  auto complete_write(int result) -> void;
+
+  /// Submit the remaining data of the oldest queued write; this must be called while holding the write lock.
+  auto submit_write() -> bool;
+
+  /// Post a read into the read buffer.
+  auto submit_read() -> bool;
+
+  /// Add a request to the submission queue and submit it to the kernel.
+  auto submit(const struct io_uring_sqe & request) -> bool;
+
+  int fd_;
+  bool reads_datagrams_;
+  int ring_fd_{-1};
+
+  io_uring_params params_{};
+
+  // Memory shared with the kernel.
+  void * sq_ring_{nullptr};
+  std::size_t sq_ring_size_{0};
+  void * cq_ring_{nullptr};
+  std::size_t cq_ring_size_{0};
+  struct io_uring_sqe * sqes_{nullptr};
+
+  std::uint32_t * sq_head_{nullptr};
+  std::uint32_t * sq_tail_{nullptr};
+  std::uint32_t * sq_array_{nullptr};
+  std::uint32_t * cq_head_{nullptr};
+  std::uint32_t * cq_tail_{nullptr};
+  struct io_uring_cqe * cqes_{nullptr};
+
+  // Submissions may come from any thread, while completions are only processed by the reactor thread.
+  std::mutex submission_lock_;
+
+  // The first registered buffer is used for reads and the remaining buffers are used for writes.
+  std::vector<std::uint8_t> read_buffer_;
+  std::vector<std::uint8_t> write_buffers_;
+
+  // The read is only posted and completed by the reactor thread (or the destructor, once the reactor has stopped
+  // servicing the ring).
+  bool read_posted_{false};
+
+  // Queued writes are stored in consecutive write buffers (wrapping around), starting with the write in flight. An error
+  // reported by a completion is returned by the next write.
+  std::array<WriteBuffer, N_WRITE_BUFFERS> writes_{};
+  std::size_t first_write_{0};
+  std::size_t n_writes_{0};
+  bool write_in_flight_{false};
+  int write_error_{0};
+  std::mutex write_lock_;
+};
+
+}  // namespace libreach::protocol
@@ -0,0 +1,149 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+namespace libreach
+{
+
+/// A bounded, lock-free queue that supports multiple producers and multiple consumers. Each slot stores a sequence
+/// number that indicates whether it is ready to be written to or read from, as described by Dmitry Vyukov:
+///   https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template <typename T>
+class MpmcQueue
+{
+  static_assert(std::is_trivially_copyable_v<T>, "Values are copied in and out of the queue as bytes.");
+
+public:
+  /// Create a queue that can store at least the given number of values; the capacity is rounded up to a power of two.
+  explicit MpmcQueue(std::size_t capacity)
+  : capacity_(std::bit_ceil(std::max<std::size_t>(capacity, 1))),
+    slots_(std::make_unique<Slot[]>(capacity_))
+  {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Get the number of values that the queue can store.
+  [[nodiscard]] auto capacity() const -> std::size_t { return capacity_; }
+
+  /// Add a value to the queue; this may be called from any thread. Returns false if the queue is full.
+  auto try_push(const T & value) -> bool
+  {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+
+    while (true) {
+      Slot & slot = slots_[pos & (capacity_ - 1)];
+      const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+      if (difference == 0) {
+        // The slot is free; claim it by moving the tail past it
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          slot.value = std::bit_cast<Storage>(value);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        // The slot still holds a value from the previous lap. The queue is only full if no consumer has claimed that
+        // value yet; otherwise, the consumer is still reading it (e.g., it was preempted) and the slot is about to be
+        // released
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const auto size = static_cast<std::intptr_t>(pos) - static_cast<std::intptr_t>(head);
+        if (size >= static_cast<std::intptr_t>(capacity_)) {
+          return false;
+        }
+        std::this_thread::yield();
+        pos = tail_.load(std::memory_order_relaxed);
+      } else {
+        // Another producer claimed the slot first
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Remove the value at the front of the queue, if any; this may be called from any thread. This also returns no
+  /// value if the value at the front has been claimed by a producer that has not finished writing it.
+  auto try_pop() -> std::optional<T>
+  {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+
+    while (true) {
+      Slot & slot = slots_[pos & (capacity_ - 1)];
+      const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+
+      if (difference == 0) {
+        // The slot has been written; claim it by moving the head past it
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          const T value = std::bit_cast<T>(slot.value);
+
+          // Release the slot to be written on the producers' next lap
+          slot.sequence.store(pos + capacity_, std::memory_order_release);
+          return value;
+        }
+      } else if (difference < 0) {
+        // The slot has not been written yet, so the queue is empty
+        return std::nullopt;
+      } else {
+        // Another consumer claimed the slot first
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+private:
+  struct Storage
+  {
+    alignas(T) std::array<std::byte, sizeof(T)> bytes;
+  };
+
+  struct Slot
+  {
+    std::atomic<std::size_t> sequence;
+    Storage value;
+  };
+
+  std::size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // The producers and consumers are kept on separate cache lines to avoid false sharing.
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  alignas(64) std::atomic<std::size_t> head_{0};
+};
+
+}  // namespace libreach
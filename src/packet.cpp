@@ -26,116 +26,225 @@
 #include "libreach/packet.hpp"
 
 #include <algorithm>
+#include <array>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
+#include <type_traits>
 
 #include "cobs.hpp"
 #include "crc.hpp"
+#include "packet_parser.hpp"
+#include "simd.hpp"
 
 namespace libreach
 {
 
-Packet::Packet(PacketId packet_id, std::uint8_t device_id, std::vector<std::uint8_t> data)
+static_assert(std::is_trivially_copyable_v<Packet>, "Packets must be trivially copyable.");
+
+Packet::Packet(PacketId packet_id, std::uint8_t device_id, std::span<const std::uint8_t> data)
 : packet_id_(packet_id),
   device_id_(device_id),
-  data_(std::move(data))
+  data_size_(0)
 {
-  if (data_.empty()) {
+  if (data.empty()) {
     throw std::invalid_argument("Cannot create a packet with empty data.");
   }
+
+  if (data.size() > MAX_PACKET_DATA_SIZE) {
+    throw std::invalid_argument("Cannot create a packet with more than 251 bytes of data.");
+  }
+
+  std::ranges::copy(data, data_.begin());
+  data_size_ = static_cast<std::uint8_t>(data.size());
+}
+
+Packet::Packet(PacketId packet_id, std::uint8_t device_id, std::initializer_list<std::uint8_t> data)
+: Packet(packet_id, device_id, std::span<const std::uint8_t>(data.begin(), data.size()))
+{
+}
+
+Packet::Packet(const PacketView & view)
+: Packet(view.packet_id(), view.device_id(), view.data())
+{
 }
 
 auto Packet::packet_id() const -> PacketId { return packet_id_; }
 
 auto Packet::device_id() const -> std::uint8_t { return device_id_; }
 
-auto Packet::data() const -> std::vector<std::uint8_t> { return data_; }
+auto Packet::data() const -> std::span<const std::uint8_t> { return {data_.data(), data_size_}; }
 
-auto Packet::data_size() const -> std::size_t { return data_.size(); }
+auto Packet::data_size() const -> std::size_t { return data_size_; }
 
 namespace protocol
 {
 
-auto encode_packet(const Packet & packet) -> std::vector<std::uint8_t>
+namespace
 {
-  std::vector<std::uint8_t> data(packet.data());
 
-  data.push_back(static_cast<std::uint8_t>(packet.packet_id()));
-  data.push_back(static_cast<std::uint8_t>(packet.device_id()));
+/// Decode a single COBS-encoded frame in place and return a view of the decoded packet.
+auto try_decode_frame(std::span<std::uint8_t> frame) -> DecodeResult<PacketView>
+{
+  if (frame.empty()) {
+    return DecodeError::EMPTY_FRAME;
+  }
 
-  // Length is the current buffer size plus two (length and CRC)
-  data.push_back(data.size() + 2);
+  const std::optional<std::size_t> decoded_size = try_decode_cobs(frame, frame);
 
-  data.push_back(calculate_crc(data));
+  if (!decoded_size) {
+    return DecodeError::INVALID_ENCODING;
+  }
 
-  return encode_cobs(data);
+  return try_parse_packet(frame.first(*decoded_size));
 }
 
-auto decode_packet(const std::vector<std::uint8_t> & data) -> Packet
-{
-  if (data.empty()) {
-    throw std::invalid_argument("Cannot decode an empty byte stream.");
-  }
-
-  std::vector<std::uint8_t> decoded_data = decode_cobs(data);
+}  // namespace
 
-  if (decoded_data.empty()) {
-    throw std::runtime_error("Decoded data is empty");
+auto try_parse_packet(std::span<const std::uint8_t> decoded_data) -> DecodeResult<PacketView>
+{
+  // The decoded data must contain at least the packet ID, device ID, length, and CRC
+  if (decoded_data.size() < 4) {
+    return DecodeError::TOO_SHORT;
   }
 
   const std::uint8_t actual_crc = decoded_data.back();
-  decoded_data.pop_back();
+  decoded_data = decoded_data.first(decoded_data.size() - 1);
 
   const std::uint8_t expected_crc = calculate_crc(decoded_data);
 
   if (actual_crc != expected_crc) {
-    throw std::runtime_error("The expected and actual CRC values do not match.");
+    return DecodeError::CRC_MISMATCH;
   }
 
-  const auto length = static_cast<std::vector<std::uint8_t>::size_type>(decoded_data.back());
-  decoded_data.pop_back();
+  const auto length = static_cast<std::size_t>(decoded_data.back());
+  decoded_data = decoded_data.first(decoded_data.size() - 1);
 
   if ((decoded_data.size() + 2) != length) {
-    throw std::runtime_error("The specified payload size is not equal to the actual payload size.");
+    return DecodeError::LENGTH_MISMATCH;
+  }
+
+  const std::uint8_t device_id = decoded_data[decoded_data.size() - 1];
+  const std::uint8_t packet_id = decoded_data[decoded_data.size() - 2];
+
+  return PacketView(static_cast<PacketId>(packet_id), device_id, decoded_data.first(decoded_data.size() - 2));
+}
+
+auto encode_packet(const Packet & packet) -> std::vector<std::uint8_t>
+{
+  std::vector<std::uint8_t> data(MAX_ENCODED_PACKET_SIZE);
+  data.resize(encode_packet_into(packet, data));
+  return data;
+}
+
+auto encode_packet_into(const Packet & packet, std::span<std::uint8_t> out) -> std::size_t
+{
+  // Length is the data size plus four (packet ID, device ID, length, and CRC)
+  const std::size_t length = packet.data_size() + 4;
+
+  if (out.size() < max_cobs_encoded_size(length)) {
+    throw std::invalid_argument("The output buffer is too small to store the encoded packet.");
+  }
+
+  CobsEncoder encoder(out);
+  std::uint8_t crc = CRC_INITIAL_VALUE;
+
+  const auto push = [&encoder, &crc](std::uint8_t byte) {
+    crc = update_crc(crc, byte);
+    encoder.push(byte);
+  };
+
+  for (const std::uint8_t byte : packet.data()) {
+    push(byte);
   }
 
-  const std::uint8_t device_id = decoded_data.back();
-  decoded_data.pop_back();
+  push(static_cast<std::uint8_t>(packet.packet_id()));
+  push(packet.device_id());
+  push(static_cast<std::uint8_t>(length));
 
-  const std::uint8_t packet_id = decoded_data.back();
-  decoded_data.pop_back();
+  encoder.push(finalize_crc(crc));
 
-  return Packet(static_cast<PacketId>(packet_id), device_id, decoded_data);
+  return encoder.finish();
 }
 
-auto decode_packets(const std::vector<std::uint8_t> & data) -> std::vector<Packet>
+auto decode_packet(std::span<const std::uint8_t> data) -> Packet
 {
   if (data.empty()) {
-    throw std::invalid_argument("Cannot decode an empty buffer.");
+    throw std::invalid_argument("Cannot decode an empty byte stream.");
   }
 
-  std::vector<Packet> packets;
+  return try_decode_packet(data).value();
+}
 
-  auto start = data.begin();
-  auto iter = std::find_if(start, data.end(), [](const std::uint8_t & b) { return b == PACKET_DELIMITER; });
+auto try_decode_packet(std::span<const std::uint8_t> data) -> DecodeResult<Packet>
+{
+  if (data.empty()) {
+    return DecodeError::EMPTY_FRAME;
+  }
 
-  while (iter != data.end()) {
-    const std::vector<std::uint8_t> packet_data(start, iter);
+  // Only the bytes up to the first delimiter belong to the frame
+  const std::span<const std::uint8_t> encoded = data.first(find_zero(data));
 
-    start = iter + 1;
-    iter = std::find_if(start, data.end(), [](const std::uint8_t & b) { return b == PACKET_DELIMITER; });
+  if (encoded.size() >= MAX_ENCODED_PACKET_SIZE) {
+    return DecodeError::TOO_LONG;
+  }
 
-    if (packet_data.empty()) {
+  std::array<std::uint8_t, MAX_ENCODED_PACKET_SIZE> frame;
+  std::ranges::copy(encoded, frame.begin());
+
+  const DecodeResult<PacketView> packet = try_decode_frame(std::span(frame).first(encoded.size()));
+
+  if (!packet) {
+    return packet.error();
+  }
+
+  return Packet(*packet);
+}
+
+auto decode_packets(std::span<std::uint8_t> data) -> std::vector<PacketView>
+{
+  if (data.empty()) {
+    throw std::invalid_argument("Cannot decode an empty buffer.");
+  }
+
+  std::vector<PacketView> packets;
+
+  for (const auto & packet : try_decode_packets(data)) {
+    if (!packet) {
+      std::cout << "An error occurred while attempting to decode a packet: " << to_string(packet.error()) << "\n";
       continue;
     }
+    packets.push_back(*packet);
+  }
+
+  return packets;
+}
+
+auto try_decode_packets(std::span<std::uint8_t> data) -> std::vector<DecodeResult<PacketView>>
+{
+  static_assert(PACKET_DELIMITER == 0x00, "Frames are located by searching for zero bytes.");
 
-    try {
-      const Packet packet = decode_packet(packet_data);
-      packets.push_back(packet);
+  std::vector<DecodeResult<PacketView>> packets;
+
+  std::size_t start = 0;
+
+  while (start < data.size()) {
+    const std::size_t frame_size = find_zero(data.subspan(start));
+
+    // Bytes that follow the final delimiter do not form a complete frame
+    if (start + frame_size == data.size()) {
+      break;
     }
-    catch (const std::exception & e) {
-      std::cout << "An error occurred while attempting to decode a packet: " << e.what() << "\n";
+
+    const std::span<std::uint8_t> packet_data = data.subspan(start, frame_size);
+    start += frame_size + 1;
+
+    // Consecutive delimiters do not contain a frame
+    if (packet_data.empty()) {
+      continue;
     }
+
+    packets.push_back(try_decode_frame(packet_data));
   }
 
   return packets;
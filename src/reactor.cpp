@@ -0,0 +1,272 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "libreach/reactor.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+
+namespace libreach::protocol
+{
+
+Reactor::Reactor()
+{
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    throw std::runtime_error("Failed to create the reactor's epoll instance.");
+  }
+
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeup_fd_ < 0) {
+    close(epoll_fd_);
+    throw std::runtime_error("Failed to create the reactor's wakeup event.");
+  }
+
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = wakeup_fd_;
+
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event) < 0) {
+    close(wakeup_fd_);
+    close(epoll_fd_);
+    throw std::runtime_error("Failed to register the reactor's wakeup event.");
+  }
+
+  running_.store(true);
+  reactor_thread_ = std::thread(&Reactor::run, this);
+}
+
+Reactor::~Reactor()
+{
+  running_.store(false);
+
+  const std::uint64_t wakeup = 1;
+  if (write(wakeup_fd_, &wakeup, sizeof(wakeup)) < 0) {
+    std::cout << "Failed to wake up the reactor thread.\n";
+  }
+
+  if (reactor_thread_.joinable()) {
+    reactor_thread_.join();
+  }
+
+  close(wakeup_fd_);
+  close(epoll_fd_);
+}
+
+auto Reactor::shared() -> std::shared_ptr<Reactor>
+{
+  static std::mutex shared_reactor_lock;
+  static std::weak_ptr<Reactor> shared_reactor;
+
+  const std::lock_guard<std::mutex> lock(shared_reactor_lock);
+
+  auto reactor = shared_reactor.lock();
+  if (!reactor) {
+    reactor = std::make_shared<Reactor>();
+    shared_reactor = reactor;
+  }
+
+  return reactor;
+}
+
+auto Reactor::add_reader(int fd, std::function<void(bool)> && callback) -> void
+{
+  add(fd, EPOLLIN | EPOLLRDHUP, std::move(callback));
+}
+
+auto Reactor::add_writer(int fd, std::function<void(bool)> && callback) -> void
+{
+  add(fd, EPOLLOUT, std::move(callback));
+}
+
+auto Reactor::add(int fd, std::uint32_t events, std::function<void(bool)> && callback) -> void
+{
+  const std::lock_guard<std::mutex> lock(callbacks_lock_);
+
+  struct epoll_event event = {};
+  event.events = events;
+  event.data.fd = fd;
+
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    throw std::runtime_error("Failed to register the file descriptor with the reactor.");
+  }
+
+  callbacks_[fd] = std::make_shared<std::function<void(bool)>>(std::move(callback));
+}
+
+namespace
+{
+
+auto to_timespec(std::chrono::nanoseconds duration) -> struct timespec
+{
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
+  return {seconds.count(), (duration - seconds).count()};
+}
+
+}  // namespace
+
+auto Reactor::add_timer(std::chrono::nanoseconds period, std::function<void()> && callback) -> int
+{
+  if (period <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("The timer period must be positive.");
+  }
+
+  return create_timer(period, period, std::move(callback));
+}
+
+auto Reactor::add_deadline(std::function<void()> && callback) -> int
+{
+  return create_timer(std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero(), std::move(callback));
+}
+
+auto Reactor::set_deadline(int timer, std::chrono::nanoseconds delay) -> void
+{
+  // A zero expiration disarms a timerfd, so the shortest possible delay is used instead
+  struct itimerspec spec = {};
+  spec.it_value = to_timespec(std::max(delay, std::chrono::nanoseconds(1)));
+
+  if (timerfd_settime(timer, 0, &spec, nullptr) < 0) {
+    throw std::runtime_error("Failed to set the deadline of a timer.");
+  }
+}
+
+auto Reactor::create_timer(
+  std::chrono::nanoseconds expiration,
+  std::chrono::nanoseconds period,
+  std::function<void()> && callback) -> int
+{
+  const int timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timer < 0) {
+    throw std::runtime_error("Failed to create a timer.");
+  }
+
+  struct itimerspec spec = {};
+  spec.it_interval = to_timespec(period);
+  spec.it_value = to_timespec(expiration);
+
+  if (timerfd_settime(timer, 0, &spec, nullptr) < 0) {
+    close(timer);
+    throw std::runtime_error("Failed to start a timer.");
+  }
+
+  try {
+    add_reader(timer, [timer, callback = std::move(callback)](bool /*hangup*/) {
+      // The number of expirations must be read to rearm the timer; missed expirations are not made up
+      std::uint64_t expirations = 0;
+      if (read(timer, &expirations, sizeof(expirations)) > 0) {
+        callback();
+      }
+    });
+  }
+  catch (const std::exception &) {
+    close(timer);
+    throw;
+  }
+
+  return timer;
+}
+
+auto Reactor::remove_reader(int fd) -> void { remove(fd); }
+
+auto Reactor::remove_writer(int fd) -> void { remove(fd); }
+
+auto Reactor::remove_timer(int timer) -> void
+{
+  remove(timer);
+  close(timer);
+}
+
+auto Reactor::remove(int fd) -> void
+{
+  {
+    const std::lock_guard<std::mutex> lock(callbacks_lock_);
+    if (callbacks_.erase(fd) > 0) {
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+  }
+
+  // Wait for the callbacks that are currently being executed to finish, even if the file descriptor was not registered,
+  // because a callback may have removed itself before doing more work; a callback cannot wait for itself
+  if (std::this_thread::get_id() != reactor_thread_.get_id()) {
+    const std::lock_guard<std::mutex> lock(dispatch_lock_);
+  }
+}
+
+auto Reactor::run() -> void
+{
+  std::array<struct epoll_event, 16> events;
+
+  while (running_.load()) {
+    const int n_events = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+
+    if (n_events < 0) {
+      if (errno != EINTR) {
+        std::cout << "The reactor failed to wait for events.\n";
+      }
+      continue;
+    }
+
+    const std::lock_guard<std::mutex> dispatch_lock(dispatch_lock_);
+
+    for (const auto & event : std::span(events).first(static_cast<std::size_t>(n_events))) {
+      if (event.data.fd == wakeup_fd_) {
+        continue;
+      }
+
+      std::shared_ptr<std::function<void(bool)>> callback;
+      {
+        const std::lock_guard<std::mutex> lock(callbacks_lock_);
+        const auto it = callbacks_.find(event.data.fd);
+
+        // The file descriptor may have been removed by a callback executed earlier in this batch
+        if (it == callbacks_.end()) {
+          continue;
+        }
+        callback = it->second;
+      }
+
+      try {
+        // Errors are reported as hang-ups: epoll is level-triggered, so a connection that has failed would otherwise
+        // be reported again on every iteration
+        (*callback)((event.events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) != 0);
+      }
+      catch (const std::exception & e) {
+        std::cout << "An error occurred while executing a reactor callback: " << e.what() << "\n";
+      }
+    }
+  }
+}
+
+}  // namespace libreach::protocol
@@ -0,0 +1,181 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "libreach/redundant_client.hpp"
+
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+
+namespace libreach::protocol
+{
+
+namespace
+{
+
+const std::uint8_t PRIMARY = 0;
+const std::uint8_t SECONDARY = 1;
+
+/// Compute the 64-bit FNV-1a hash of the packet data. The data of a packet is at most 254 bytes, so this is cheaper
+/// than storing a copy of each packet.
+auto digest(std::span<const std::uint8_t> data) -> std::uint64_t
+{
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (const std::uint8_t byte : data) {
+    hash = (hash ^ byte) * 0x100000001b3;
+  }
+  return hash ^ data.size();
+}
+
+}  // namespace
+
+RedundantClient::RedundantClient(
+  const ClientFactory & primary,
+  const ClientFactory & secondary,
+  std::function<void(PacketView)> && callback,
+  std::chrono::milliseconds session_timeout,
+  RedundancyMode mode,
+  std::chrono::milliseconds duplicate_window,
+  std::shared_ptr<Reactor> reactor)
+: Client(std::forward<std::function<void(PacketView)>>(callback), session_timeout, std::move(reactor)),
+  mode_(mode),
+  duplicate_window_(duplicate_window)
+{
+  primary_ = primary([this](PacketView packet) { receive_from_transport(PRIMARY, packet); });
+  secondary_ = secondary([this](PacketView packet) { receive_from_transport(SECONDARY, packet); });
+
+  if (!primary_ || !secondary_) {
+    throw std::invalid_argument("Both transports of a redundant client must be created.");
+  }
+}
+
+RedundantClient::~RedundantClient()
+{
+  // The transports are destroyed outside of the lock because destroying them waits for their reactor callbacks
+  std::unique_ptr<Client> primary;
+  std::unique_ptr<Client> secondary;
+  {
+    const std::unique_lock<std::shared_mutex> lock(transports_lock_);
+    primary = std::move(primary_);
+    secondary = std::move(secondary_);
+  }
+  primary.reset();
+  secondary.reset();
+
+  shutdown_client();
+}
+
+auto RedundantClient::native_handle() const -> int { return -1; }
+
+auto RedundantClient::set_heartbeat_frequency(std::uint8_t frequency) -> void
+{
+  Client::set_heartbeat_frequency(frequency);
+
+  const std::shared_lock<std::shared_mutex> lock(transports_lock_);
+  if (primary_ && secondary_) {
+    primary_->set_heartbeat_frequency(frequency);
+    secondary_->set_heartbeat_frequency(frequency);
+  }
+}
+
+auto RedundantClient::primary_connected() const -> bool
+{
+  const std::shared_lock<std::shared_mutex> lock(transports_lock_);
+  return primary_ && primary_->connected();
+}
+
+auto RedundantClient::secondary_connected() const -> bool
+{
+  const std::shared_lock<std::shared_mutex> lock(transports_lock_);
+  return secondary_ && secondary_->connected();
+}
+
+auto RedundantClient::duplicates_dropped() const -> std::uint64_t { return duplicates_dropped_.load(); }
+
+auto RedundantClient::receive_from_transport(std::uint8_t transport, PacketView packet) -> void
+{
+  if (is_duplicate(transport, packet)) {
+    duplicates_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  receive_packet(packet);
+}
+
+auto RedundantClient::is_duplicate(std::uint8_t transport, PacketView packet) -> bool
+{
+  const auto now = std::chrono::steady_clock::now();
+  const std::uint64_t packet_digest = digest(packet.data());
+  const auto key = static_cast<std::uint16_t>(packet.device_id() << 8 | static_cast<std::uint8_t>(packet.packet_id()));
+
+  const std::lock_guard<std::mutex> lock(recent_packets_lock_);
+  RecentPackets & recent = recent_packets_[key];
+
+  for (auto & recent_packet : recent.packets) {
+    if (
+      !recent_packet.matched && recent_packet.transport != transport && recent_packet.digest == packet_digest &&
+      now - recent_packet.received <= duplicate_window_) {
+      recent_packet.matched = true;
+      return true;
+    }
+  }
+
+  recent.packets[recent.next] = RecentPacket{packet_digest, now, transport, false};
+  recent.next = (recent.next + 1) % RecentPackets::DEPTH;
+
+  return false;
+}
+
+auto RedundantClient::read_bytes(std::span<std::uint8_t> /*buffer*/) const -> ssize_t { return 0; }
+
+auto RedundantClient::write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t
+{
+  const std::shared_lock<std::shared_mutex> lock(transports_lock_);
+
+  if (!primary_ || !secondary_) {
+    errno = ENOTCONN;
+    return -1;
+  }
+
+  if (mode_ == RedundancyMode::FAILOVER) {
+    // A failed write fails over immediately instead of waiting for the primary transport to time out
+    if (primary_->connected()) {
+      const ssize_t written = forward_bytes(*primary_, data);
+      return written >= 0 ? written : forward_bytes(*secondary_, data);
+    }
+    if (secondary_->connected()) {
+      return forward_bytes(*secondary_, data);
+    }
+  }
+
+  // Data is sent over both transports when broadcasting or when neither transport is connected (e.g., to restore the
+  // heartbeat); the write succeeds if either transport accepts the data
+  const ssize_t primary_written = forward_bytes(*primary_, data);
+  const ssize_t secondary_written = forward_bytes(*secondary_, data);
+
+  return primary_written >= 0 ? primary_written : secondary_written;
+}
+
+}  // namespace libreach::protocol
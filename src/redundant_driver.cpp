@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "libreach/redundant_driver.hpp"
+
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include "libreach/udp_client.hpp"
+
+namespace libreach
+{
+
+RedundantDriver::RedundantDriver(
+  const std::string & addr,
+  std::uint16_t port,
+  const std::string & serial_port,
+  protocol::RedundancyMode mode,
+  std::size_t q_size,
+  std::size_t n_workers,
+  std::chrono::milliseconds session_timeout,
+  bool low_latency,
+  std::uint32_t baud_rate,
+  TransmitMode transmit_mode,
+  DispatchMode dispatch_mode)
+: ReachDriver(
+    std::make_unique<protocol::RedundantClient>(
+      [&addr, port, session_timeout](std::function<void(PacketView)> && callback) {
+        return std::make_unique<protocol::UdpClient>(addr, port, std::move(callback), session_timeout);
+      },
+      [&serial_port, session_timeout, low_latency, baud_rate](std::function<void(PacketView)> && callback) {
+        return std::make_unique<protocol::SerialClient>(
+          serial_port,
+          std::move(callback),
+          session_timeout,
+          32,       // Maximum number of bytes to read on each poll
+          nullptr,  // Use the shared reactor
+          low_latency,
+          baud_rate);
+      },
+      nullptr,  // The packet callback is set once the driver has been constructed
+      session_timeout,
+      mode),
+    q_size,
+    n_workers,
+    transmit_mode,
+    dispatch_mode),
+  redundant_client_(static_cast<protocol::RedundantClient *>(client_.get()))
+{
+}
+
+auto RedundantDriver::ethernet_connected() const -> bool { return redundant_client_->primary_connected(); }
+
+auto RedundantDriver::serial_connected() const -> bool { return redundant_client_->secondary_connected(); }
+
+auto RedundantDriver::duplicates_dropped() const -> std::uint64_t { return redundant_client_->duplicates_dropped(); }
+
+}  // namespace libreach
@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "libreach/replay_client.hpp"
+
+#include <optional>
+#include <stdexcept>
+
+namespace libreach::protocol
+{
+
+ReplayClient::ReplayClient(
+  const std::string & path,
+  std::function<void(PacketView)> && callback,
+  std::chrono::milliseconds session_timeout,
+  ReplaySpeed speed,
+  std::shared_ptr<Reactor> reactor)
+: Client(std::forward<std::function<void(PacketView)>>(callback), session_timeout, std::move(reactor)),
+  reader_(path),
+  speed_(speed)
+{
+}
+
+ReplayClient::~ReplayClient()
+{
+  {
+    const std::lock_guard<std::mutex> lock(stop_lock_);
+    stopping_.store(true);
+  }
+  stop_cv_.notify_all();
+
+  if (replay_thread_.joinable()) {
+    replay_thread_.join();
+  }
+
+  shutdown_client();
+}
+
+auto ReplayClient::native_handle() const -> int { return -1; }
+
+auto ReplayClient::start() -> void
+{
+  if (replay_thread_.joinable()) {
+    throw std::runtime_error("The capture has already been replayed.");
+  }
+
+  replay_thread_ = std::thread([this] { replay(); });
+}
+
+auto ReplayClient::finished() const -> bool { return finished_.load(); }
+
+auto ReplayClient::wait_until_finished() const -> void { finished_.wait(false); }
+
+auto ReplayClient::replay() -> void
+{
+  const auto start_time = std::chrono::steady_clock::now();
+  std::optional<std::chrono::nanoseconds> first_timestamp;
+
+  while (auto record = reader_.next()) {
+    if (stopping_.load()) {
+      break;
+    }
+
+    if (record->direction != CaptureDirection::RECEIVED) {
+      continue;
+    }
+
+    if (speed_ == ReplaySpeed::ORIGINAL) {
+      if (!first_timestamp) {
+        first_timestamp = record->timestamp;
+      }
+
+      const auto replay_time = start_time + (record->timestamp - *first_timestamp);
+
+      std::unique_lock<std::mutex> lock(stop_lock_);
+      if (stop_cv_.wait_until(lock, replay_time, [this] { return stopping_.load(); })) {
+        break;
+      }
+    }
+
+    receive_bytes(record->data, record->datagram);
+  }
+
+  finished_.store(true);
+  finished_.notify_all();
+}
+
+auto ReplayClient::read_bytes(std::span<std::uint8_t> /*buffer*/) const -> ssize_t { return 0; }
+
+auto ReplayClient::write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t
+{
+  return static_cast<ssize_t>(data.size());
+}
+
+}  // namespace libreach::protocol
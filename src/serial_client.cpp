@@ -26,29 +26,52 @@
 #include "libreach/serial_client.hpp"
 
 #include <fcntl.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
 
-#include <algorithm>
 #include <iostream>
-#include <ranges>
 #include <stdexcept>
 
+#include "baud_rate.hpp"
+
 namespace libreach::protocol
 {
 
 SerialClient::SerialClient(
   const std::string & port,
-  std::function<void(const std::vector<Packet> &)> && callback,
-  std::chrono::seconds session_timeout,
-  std::uint16_t max_bytes_to_read)
-: Client(std::forward<std::function<void(const std::vector<Packet> &)>>(callback), session_timeout)
+  std::function<void(PacketView)> && callback,
+  std::chrono::milliseconds session_timeout,
+  std::uint16_t max_bytes_to_read,
+  std::shared_ptr<Reactor> reactor,
+  bool low_latency,
+  std::uint32_t baud_rate)
+: Client(std::forward<std::function<void(PacketView)>>(callback), session_timeout, std::move(reactor)),
+  port_(port),
+  baud_rate_(baud_rate),
+  low_latency_(low_latency)
 {
   if (port.empty()) {
     throw std::invalid_argument("Attempted to open file using an empty file path.");
   }
 
-  handle_ = open(port.c_str(), O_RDWR | O_NOCTTY);
+  open_port();
+
+  start_polling_connection(max_bytes_to_read);
+}
+
+SerialClient::~SerialClient()
+{
+  shutdown_client();
+  if (handle_ >= 0) {
+    close(handle_);
+  }
+}
+
+auto SerialClient::open_port() -> void
+{
+  handle_ = open(port_.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
 
   if (handle_ < 0) {
     throw std::runtime_error(
@@ -59,13 +82,11 @@ SerialClient::SerialClient(
   struct termios tty;
 
   if (tcgetattr(handle_, &tty) < 0) {
+    close(handle_);
+    handle_ = -1;
     throw std::runtime_error("Unable to get the current terminal configurations.");
   }
 
-  // Set the baudrate to 115200
-  cfsetispeed(&tty, B115200);
-  cfsetospeed(&tty, B115200);
-
   tty.c_cflag |= (CLOCAL | CREAD);         // Enable the receiver and set the mode to local mode
   tty.c_cflag &= ~CSIZE;                   // Mask the character size bits
   tty.c_cflag |= CS8;                      // Use 8 data bits per byte
@@ -84,35 +105,71 @@ SerialClient::SerialClient(
   tty.c_oflag &= ~OPOST;  // Disable output post-processing
   tty.c_oflag &= ~ONLCR;  // Disable conversion of newline to carriage return
 
-  tty.c_cc[VTIME] = 1;  // Set the timeout to 0.1s
-  tty.c_cc[VMIN] = max_bytes_to_read;
+  // Return from a read as soon as any data is available. Reads are only performed once the reactor reports that data
+  // has been received, and a read only returns zero bytes once the port has been hung up.
+  tty.c_cc[VTIME] = 0;
+  tty.c_cc[VMIN] = 1;
 
   // Save the configurations
   if (tcsetattr(handle_, TCSANOW, &tty) != 0) {
+    close(handle_);
+    handle_ = -1;
     throw std::runtime_error("Unable to save the terminal configurations.");
   }
 
-  start_polling_connection(max_bytes_to_read);
+  // The baud rate is set separately to support rates that do not have a predefined constant
+  try {
+    set_baud_rate(handle_, baud_rate_);
+  }
+  catch (const std::exception &) {
+    close(handle_);
+    handle_ = -1;
+    throw;
+  }
+
+  if (low_latency_) {
+    enable_low_latency();
+  }
 }
 
-SerialClient::~SerialClient()
+auto SerialClient::reopen_connection() -> bool
 {
-  shutdown_client();
-  close(handle_);
+  if (handle_ >= 0) {
+    close(handle_);
+    handle_ = -1;
+  }
+
+  // A USB serial adapter that was re-enumerated is available at the same path once it has been reconnected
+  open_port();
+  return true;
 }
 
-auto SerialClient::write_to_connection(const std::vector<std::uint8_t> & data) const -> ssize_t
+auto SerialClient::enable_low_latency() const -> void
 {
-  return write(handle_, data.data(), data.size());
+  struct serial_struct serial;
+
+  if (ioctl(handle_, TIOCGSERIAL, &serial) < 0) {
+    std::cout << "Unable to enable low-latency mode; the serial driver does not support it.\n";
+    return;
+  }
+
+  serial.flags |= ASYNC_LOW_LATENCY;
+
+  if (ioctl(handle_, TIOCSSERIAL, &serial) < 0) {
+    std::cout << "Unable to enable low-latency mode; the serial driver rejected the configuration.\n";
+  }
 }
 
-auto SerialClient::read_bytes(std::deque<std::uint8_t> & buffer, std::size_t n_bytes) const -> ssize_t
+auto SerialClient::native_handle() const -> int { return handle_; }
+
+auto SerialClient::write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t
 {
-  std::vector<std::uint8_t> data(n_bytes);
-  const ssize_t bytes_read = read(handle_, data.data(), n_bytes);
-  std::ranges::copy(data | std::views::take(bytes_read), std::back_inserter(buffer));
+  return write(handle_, data.data(), data.size());
+}
 
-  return bytes_read;
+auto SerialClient::read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t
+{
+  return read(handle_, buffer.data(), buffer.size());
 }
 
 }  // namespace libreach::protocol
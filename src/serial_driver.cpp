@@ -35,15 +35,31 @@ SerialDriver::SerialDriver(
   const std::string & port,
   std::size_t q_size,
   std::size_t n_workers,
-  std::chrono::seconds session_timeout)
+  std::chrono::milliseconds session_timeout,
+  bool low_latency,
+  std::uint32_t baud_rate,
+  TransmitMode transmit_mode,
+  DispatchMode dispatch_mode)
 : ReachDriver(
     std::make_unique<protocol::SerialClient>(
       port,
-      [this](const std::vector<Packet> & packets) { receive_packets(packets); },
-      session_timeout),
+      nullptr,  // The packet callback is set once the driver has been constructed
+      session_timeout,
+      32,       // Maximum number of bytes to read on each poll
+      nullptr,  // Use the shared reactor
+      low_latency,
+      baud_rate),
     q_size,
-    n_workers)
+    n_workers,
+    transmit_mode,
+    dispatch_mode),
+  baud_rate_(baud_rate)
 {
 }
 
+auto SerialDriver::frame_capacity(std::size_t data_size) const -> double
+{
+  return protocol::frame_capacity(baud_rate_, data_size);
+}
+
 }  // namespace libreach
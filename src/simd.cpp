@@ -0,0 +1,166 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace libreach::protocol
+{
+
+namespace
+{
+
+using FindZeroFn = std::size_t (*)(std::span<const std::uint8_t>);
+
+auto is_supported(InstructionSet isa) -> bool
+{
+#if defined(__x86_64__) || defined(__i386__)
+  // This may run during static initialization, before the CPU model has been initialized
+  __builtin_cpu_init();
+#endif
+
+  switch (isa) {
+    case InstructionSet::SCALAR:
+      return true;
+#if defined(__x86_64__) || defined(__i386__)
+    case InstructionSet::SSE2:
+      return __builtin_cpu_supports("sse2") != 0;
+    case InstructionSet::AVX2:
+      return __builtin_cpu_supports("avx2") != 0;
+#endif
+    default:
+      return false;
+  }
+}
+
+auto select_find_zero(InstructionSet isa) -> FindZeroFn
+{
+  switch (isa) {
+#if defined(__x86_64__) || defined(__i386__)
+    case InstructionSet::SSE2:
+      return &find_zero_sse2;
+    case InstructionSet::AVX2:
+      return &find_zero_avx2;
+#endif
+    default:
+      return &find_zero_scalar;
+  }
+}
+
+// Scans shorter than a single vector are handled inline to avoid the indirect call
+const std::size_t MIN_VECTORIZED_SIZE = 16;
+
+std::atomic<InstructionSet> active_isa{detect_instruction_set()};
+std::atomic<FindZeroFn> active_find_zero{select_find_zero(active_isa.load())};
+
+}  // namespace
+
+auto detect_instruction_set() -> InstructionSet
+{
+  for (const auto isa : {InstructionSet::AVX2, InstructionSet::SSE2}) {
+    if (is_supported(isa)) {
+      return isa;
+    }
+  }
+  return InstructionSet::SCALAR;
+}
+
+auto instruction_set() -> InstructionSet { return active_isa.load(std::memory_order_relaxed); }
+
+auto set_instruction_set(InstructionSet isa) -> bool
+{
+  if (!is_supported(isa)) {
+    return false;
+  }
+
+  active_isa.store(isa, std::memory_order_relaxed);
+  active_find_zero.store(select_find_zero(isa), std::memory_order_relaxed);
+
+  return true;
+}
+
+auto find_zero(std::span<const std::uint8_t> data) -> std::size_t
+{
+  if (data.size() < MIN_VECTORIZED_SIZE) {
+    return find_zero_scalar(data);
+  }
+  return active_find_zero.load(std::memory_order_relaxed)(data);
+}
+
+auto find_zero_scalar(std::span<const std::uint8_t> data) -> std::size_t
+{
+  return static_cast<std::size_t>(std::ranges::find(data, 0x00) - data.begin());
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2"))) auto find_zero_sse2(std::span<const std::uint8_t> data) -> std::size_t
+{
+  const std::uint8_t * bytes = data.data();
+  const __m128i zero = _mm_setzero_si128();
+
+  std::size_t i = 0;
+
+  for (; i + sizeof(__m128i) <= data.size(); i += sizeof(__m128i)) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+    const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)));
+
+    if (mask != 0) {
+      return i + static_cast<std::size_t>(__builtin_ctz(mask));
+    }
+  }
+
+  return i + find_zero_scalar(data.subspan(i));
+}
+
+__attribute__((target("avx2"))) auto find_zero_avx2(std::span<const std::uint8_t> data) -> std::size_t
+{
+  const std::uint8_t * bytes = data.data();
+  const __m256i zero = _mm256_setzero_si256();
+
+  std::size_t i = 0;
+
+  for (; i + sizeof(__m256i) <= data.size(); i += sizeof(__m256i)) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i));
+    const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero)));
+
+    if (mask != 0) {
+      return i + static_cast<std::size_t>(__builtin_ctz(mask));
+    }
+  }
+
+  // The remaining bytes are smaller than a single AVX2 vector, but may still fill an SSE2 vector
+  return i + find_zero_sse2(data.subspan(i));
+}
+
+#endif
+
+}  // namespace libreach::protocol
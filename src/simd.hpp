@@ -0,0 +1,70 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace libreach::protocol
+{
+
+/// Instruction sets that may be used to accelerate byte scanning.
+enum class InstructionSet : std::uint8_t
+{
+  SCALAR,
+  SSE2,
+  AVX2,
+};
+
+/// Get the fastest instruction set supported by the CPU.
+auto detect_instruction_set() -> InstructionSet;
+
+/// Get the instruction set used by find_zero.
+auto instruction_set() -> InstructionSet;
+
+/// Override the instruction set used by find_zero (e.g., for benchmarking). Returns false if the CPU does not support
+/// the requested instruction set, in which case the current selection is kept.
+auto set_instruction_set(InstructionSet isa) -> bool;
+
+/// Find the index of the first zero byte in a buffer, or data.size() if the buffer does not contain a zero byte. The
+/// fastest implementation supported by the CPU is selected at runtime.
+auto find_zero(std::span<const std::uint8_t> data) -> std::size_t;
+
+/// Scalar implementation of find_zero; this is always available and is used as the fallback.
+auto find_zero_scalar(std::span<const std::uint8_t> data) -> std::size_t;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/// SSE2 implementation of find_zero; this should only be called if the CPU supports SSE2.
+auto find_zero_sse2(std::span<const std::uint8_t> data) -> std::size_t;
+
+/// AVX2 implementation of find_zero; this should only be called if the CPU supports AVX2.
+auto find_zero_avx2(std::span<const std::uint8_t> data) -> std::size_t;
+
+#endif
+
+}  // namespace libreach::protocol
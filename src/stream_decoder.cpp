@@ -0,0 +1,156 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "libreach/stream_decoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "packet_parser.hpp"
+#include "simd.hpp"
+
+namespace libreach::protocol
+{
+
+StreamDecoder::StreamDecoder(std::function<void(PacketView)> && callback)
+: callback_(std::move(callback))
+{
+}
+
+auto StreamDecoder::decode(std::span<const std::uint8_t> bytes) -> void
+{
+  std::size_t pos = 0;
+  std::size_t frame_start = 0;
+
+  while (pos < bytes.size()) {
+    const std::uint8_t byte = bytes[pos];
+
+    if (byte == PACKET_DELIMITER) {
+      encoded_size_ += pos - frame_start;
+      complete_frame();
+      frame_start = ++pos;
+      continue;
+    }
+
+    frame_started_ = true;
+
+    if (discarding_) {
+      pos += find_zero(bytes.subspan(pos));
+      continue;
+    }
+
+    if (block_remaining_ == 0) {
+      // This is a code byte; the zero that terminated the previous block is only written once another block follows
+      if (block_has_zero_) {
+        if (frame_size_ == frame_.size()) {
+          discarding_ = true;
+          continue;
+        }
+        frame_[frame_size_++] = 0x00;
+      }
+
+      block_remaining_ = byte - 1;
+      block_has_zero_ = byte < 0xFF;
+      pos++;
+      continue;
+    }
+
+    if (frame_size_ == frame_.size()) {
+      discarding_ = true;
+      continue;
+    }
+
+    // Copy as much of the current block as is available; the copy stops early if a delimiter is found
+    const std::span<const std::uint8_t> block =
+      bytes.subspan(pos, std::min({block_remaining_, bytes.size() - pos, frame_.size() - frame_size_}));
+    const std::size_t block_size = find_zero(block);
+
+    std::memcpy(frame_.data() + frame_size_, block.data(), block_size);
+
+    frame_size_ += block_size;
+    block_remaining_ -= block_size;
+    pos += block_size;
+  }
+
+  encoded_size_ += bytes.size() - frame_start;
+}
+
+auto StreamDecoder::reset() -> void
+{
+  if (frame_started_) {
+    drop_frame();
+  }
+
+  clear_frame();
+}
+
+auto StreamDecoder::clear_frame() -> void
+{
+  frame_size_ = 0;
+  encoded_size_ = 0;
+  block_remaining_ = 0;
+  block_has_zero_ = false;
+  frame_started_ = false;
+  discarding_ = false;
+}
+
+auto StreamDecoder::drop_frame() -> void
+{
+  statistics_.frames_lost++;
+  statistics_.bytes_discarded += encoded_size_;
+}
+
+auto StreamDecoder::complete_frame() -> void
+{
+  // Consecutive delimiters do not contain a frame
+  if (!frame_started_) {
+    return;
+  }
+
+  DecodeResult<PacketView> packet = DecodeError::INVALID_ENCODING;
+
+  if (discarding_) {
+    packet = DecodeError::TOO_LONG;
+  } else if (block_remaining_ == 0) {
+    packet = try_parse_packet(std::span(frame_).first(frame_size_));
+  }
+
+  if (!packet) {
+    drop_frame();
+    clear_frame();
+    std::cout << "An error occurred while attempting to decode a packet: " << to_string(packet.error()) << "\n";
+    return;
+  }
+
+  statistics_.frames_decoded++;
+
+  // Only the frame state is cleared here, so the decoded frame remains valid until more bytes are decoded
+  clear_frame();
+
+  callback_(*packet);
+}
+
+}  // namespace libreach::protocol
@@ -0,0 +1,205 @@
+// Copyright (c) 2024 Evan Palmer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), limited
+// exclusively to use with products produced by Reach Robotics Pty Ltd, subject to
+// the following conditions:
+//
+// The Software may only be used in conjunction with products manufactured or
+// developed by Reach Robotics Pty Ltd.
+//
+// Redistributions or use of the Software in any other context, including but
+// not limited to, integration, combination, or use with other products or
+// software, are strictly prohibited without prior written authorization from Reach
+// Robotics Pty Ltd.
+//
+// All copies of the Software, in whole or in part, must retain this notice and
+// the above copyright notice.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL REACH ROBOTICS
+// PTY LTD BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT, OR OTHERWISE, ARISING FROM, OUT OF, OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "libreach/tcp_client.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace libreach::protocol
+{
+
+TcpClient::TcpClient(
+  const std::string & addr,
+  std::uint16_t port,
+  std::function<void(PacketView)> && callback,
+  std::chrono::milliseconds session_timeout,
+  std::uint16_t max_bytes_to_read,
+  std::shared_ptr<Reactor> reactor)
+: Client(std::forward<std::function<void(PacketView)>>(callback), session_timeout, std::move(reactor))
+{
+  address_.sin_family = AF_INET;
+  address_.sin_port = htons(port);
+  address_.sin_addr.s_addr = inet_addr(addr.c_str());
+
+  if (address_.sin_addr.s_addr == INADDR_NONE) {
+    throw std::runtime_error("Invalid socket address " + addr);
+  }
+
+  // The constructor waits for the connection to open; reconnecting does not
+  if (!start_connecting()) {
+    struct pollfd fd = {socket_, POLLOUT, 0};
+    while (poll(&fd, 1, -1) < 0 && errno == EINTR) {
+    }
+  }
+
+  finish_connecting();
+
+  start_polling_connection(max_bytes_to_read);
+}
+
+TcpClient::~TcpClient()
+{
+  shutdown_client();
+  if (socket_ >= 0) {
+    close(socket_);
+  }
+}
+
+auto TcpClient::start_connecting() -> bool
+{
+  const int handle = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (handle < 0) {
+    throw std::runtime_error("Failed to open TCP socket");
+  }
+
+  // The socket is connected without blocking so that the reactor thread does not wait for the handshake
+  const bool connected = connect(handle, reinterpret_cast<const struct sockaddr *>(&address_), sizeof(address_)) == 0;
+  if (!connected && errno != EINPROGRESS) {
+    close(handle);
+    throw std::runtime_error("Failed to connect to TCP socket");
+  }
+
+  socket_ = handle;
+  return connected;
+}
+
+auto TcpClient::finish_connecting() -> void
+{
+  const auto fail = [this](const std::string & message) {
+    close(socket_);
+    socket_ = -1;
+    throw std::runtime_error(message);
+  };
+
+  int error = 0;
+  socklen_t error_size = sizeof(error);
+  if (getsockopt(socket_, SOL_SOCKET, SO_ERROR, &error, &error_size) < 0 || error != 0) {
+    fail("Failed to connect to TCP socket");
+  }
+
+  // Writes block until all of the data has been sent; reads are performed using MSG_DONTWAIT
+  if (fcntl(socket_, F_SETFL, fcntl(socket_, F_GETFL) & ~O_NONBLOCK) < 0) {
+    fail("Failed to configure TCP socket");
+  }
+
+  // Packets are small and latency-sensitive, so they should be sent immediately rather than coalesced by Nagle's
+  // algorithm; batches of packets are already written together by send_packets
+  const int enable = 1;
+  if (setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)) < 0) {
+    fail("Failed to disable Nagle's algorithm on TCP socket");
+  }
+
+  enable_quick_ack();
+}
+
+auto TcpClient::reopen_connection() -> bool
+{
+  if (socket_ >= 0) {
+    close(socket_);
+    socket_ = -1;
+  }
+
+  if (!start_connecting()) {
+    return false;
+  }
+
+  finish_connecting();
+  return true;
+}
+
+auto TcpClient::finish_reopening_connection() -> void { finish_connecting(); }
+
+auto TcpClient::native_handle() const -> int { return socket_; }
+
+auto TcpClient::enable_quick_ack() const -> void
+{
+  // The kernel may return to delayed acknowledgements at any time, so this is re-enabled after each read
+  const int enable = 1;
+  setsockopt(socket_, IPPROTO_TCP, TCP_QUICKACK, &enable, sizeof(enable));
+}
+
+auto TcpClient::write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t
+{
+  std::size_t bytes_written = 0;
+
+  while (bytes_written < data.size()) {
+    const std::span<const std::uint8_t> remaining = data.subspan(bytes_written);
+    const ssize_t n = send(socket_, remaining.data(), remaining.size(), MSG_NOSIGNAL);
+
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return n;
+    }
+
+    bytes_written += static_cast<std::size_t>(n);
+  }
+
+  return static_cast<ssize_t>(bytes_written);
+}
+
+auto TcpClient::read_available() -> void
+{
+  const std::span<std::uint8_t> buffer = read_buffer();
+  const ssize_t bytes_read = read_bytes(buffer);
+
+  if (bytes_read < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      std::cout << "Failed to read from the robot; the connection was likely lost.\n";
+      lose_connection();
+    }
+    return;
+  }
+
+  // A stream socket is readable with no data once the remote end has closed the connection
+  if (bytes_read == 0) {
+    std::cout << "The robot closed the connection.\n";
+    lose_connection();
+    return;
+  }
+
+  enable_quick_ack();
+
+  receive_bytes(buffer.first(static_cast<std::size_t>(bytes_read)));
+}
+
+auto TcpClient::read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t
+{
+  return recv(socket_, buffer.data(), buffer.size(), MSG_DONTWAIT);
+}
+
+}  // namespace libreach::protocol
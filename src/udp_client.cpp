@@ -28,21 +28,33 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <iostream>
-#include <ranges>
 #include <stdexcept>
 
 namespace libreach::protocol
 {
 
+static_assert(MAX_WRITE_SIZE <= MAX_DATAGRAM_SIZE, "Each batch of packets must fit in a single datagram.");
+
 UdpClient::UdpClient(
   const std::string & addr,
   std::uint16_t port,
-  std::function<void(const std::vector<Packet> &)> && callback,
-  std::chrono::seconds session_timeout,
-  std::uint16_t max_bytes_to_read)
-: Client(std::forward<std::function<void(const std::vector<Packet> &)>>(callback), session_timeout)
+  std::function<void(PacketView)> && callback,
+  std::chrono::milliseconds session_timeout,
+  std::uint16_t max_bytes_to_read,
+  std::shared_ptr<Reactor> reactor)
+: Client(std::forward<std::function<void(PacketView)>>(callback), session_timeout, std::move(reactor)),
+  datagram_size_(std::max<std::size_t>(max_bytes_to_read, MAX_DATAGRAM_SIZE)),
+  datagram_buffers_(N_DATAGRAMS * datagram_size_)
 {
+  for (std::size_t i = 0; i < N_DATAGRAMS; ++i) {
+    datagram_iovecs_[i] = {datagram_buffers_.data() + (i * datagram_size_), datagram_size_};
+    datagrams_[i].msg_hdr.msg_iov = &datagram_iovecs_[i];
+    datagrams_[i].msg_hdr.msg_iovlen = 1;
+  }
+
   socket_ = socket(AF_INET, SOCK_DGRAM, 0);
   if (socket_ < 0) {
     throw std::runtime_error("Failed to open UDP socket");
@@ -62,7 +74,7 @@ UdpClient::UdpClient(
     throw std::runtime_error("Failed to connect to UDP socket");
   }
 
-  start_polling_connection(max_bytes_to_read);
+  start_polling_connection(static_cast<std::uint16_t>(datagram_size_));
 }
 
 UdpClient::~UdpClient()
@@ -71,18 +83,39 @@ UdpClient::~UdpClient()
   close(socket_);
 }
 
-auto UdpClient::write_to_connection(const std::vector<std::uint8_t> & data) const -> ssize_t
+auto UdpClient::native_handle() const -> int { return socket_; }
+
+auto UdpClient::write_to_connection(std::span<const std::uint8_t> data) const -> ssize_t
 {
   return send(socket_, data.data(), data.size(), 0);
 }
 
-auto UdpClient::read_bytes(std::deque<std::uint8_t> & buffer, std::size_t n_bytes) const -> ssize_t
+auto UdpClient::read_available() -> void
 {
-  std::vector<std::uint8_t> data(n_bytes);
-  const ssize_t n_read = recv(socket_, data.data(), data.size(), 0);
-  std::ranges::copy(data | std::views::take(n_read), std::back_inserter(buffer));
+  const int n_datagrams = recvmmsg(socket_, datagrams_.data(), N_DATAGRAMS, MSG_DONTWAIT, nullptr);
+
+  if (n_datagrams < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      std::cout << "Failed to read from the robot; the connection was likely lost.\n";
+    }
+    return;
+  }
 
-  return n_read;
+  for (const auto & datagram : std::span(datagrams_).first(static_cast<std::size_t>(n_datagrams))) {
+    if ((datagram.msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+      std::cout << "Received a datagram larger than " << datagram_size_ << " bytes; the datagram was truncated.\n";
+    }
+
+    const auto * data = static_cast<const std::uint8_t *>(datagram.msg_hdr.msg_iov->iov_base);
+    receive_bytes(std::span(data, datagram.msg_len), true);
+  }
+}
+
+auto UdpClient::handle_hangup() -> void { read_available(); }
+
+auto UdpClient::read_bytes(std::span<std::uint8_t> buffer) const -> ssize_t
+{
+  return recv(socket_, buffer.data(), buffer.size(), MSG_DONTWAIT);
 }
 
 }  // namespace libreach::protocol
@@ -36,15 +36,19 @@ UdpDriver::UdpDriver(
   std::uint16_t port,
   std::size_t q_size,
   std::size_t n_workers,
-  std::chrono::seconds session_timeout)
+  std::chrono::milliseconds session_timeout,
+  TransmitMode transmit_mode,
+  DispatchMode dispatch_mode)
 : ReachDriver(
     std::make_unique<protocol::UdpClient>(
       addr,
       port,
-      [this](const std::vector<Packet> & packets) { receive_packets(packets); },
+      nullptr,  // The packet callback is set once the driver has been constructed
       session_timeout),
     q_size,
-    n_workers)
+    n_workers,
+    transmit_mode,
+    dispatch_mode)
 {
 }
 